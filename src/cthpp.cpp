@@ -0,0 +1,741 @@
+// GPL3 lisence
+//
+// Created by @olokreaz on 19.10.2026.
+//
+
+#include <clang/AST/AST.h>
+#include <clang/AST/ASTContext.h>
+#include <clang/AST/Decl.h>
+#include <clang/AST/DeclCXX.h>
+#include <clang/AST/PrettyPrinter.h>
+#include <clang/Basic/Diagnostic.h>
+#include <clang/Basic/FileManager.h>
+#include <clang/Basic/SourceManager.h>
+#include <clang/Basic/TargetInfo.h>
+#include <clang/Frontend/CompilerInstance.h>
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Host.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/Regex.h>
+
+#include <conjure_enum.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+
+#include <git2.h>
+
+#include <jsoncons/json.hpp>
+
+#include <srilakshmikanthanp/libfiglet.hpp>
+
+using namespace clang;
+
+#include "./cthpp.hpp"
+#include "./pipeline.hpp"
+#include "./reflection.hpp"
+#include "./schema.hpp"
+#include "./usage_scan.hpp"
+
+std::string getHashGitCommit( const std::string& path, llvm::raw_ostream& log )
+{
+	if ( path.empty( ) ) return "";
+
+	std::string hash;
+
+	git_libgit2_init( );
+
+	git_repository* repo = nullptr;
+
+	if ( const int er = git_repository_open( &repo, path.c_str( ) ); er ) {
+		const git_error* err = giterr_last( );
+		log << "git error " << er << " " << ( err && err->message ? err->message : "Uknown error" ) << "\n";
+		git_libgit2_shutdown( );
+		return { };
+	}
+
+	git_oid oid;
+	git_reference_name_to_id( &oid, repo, "HEAD" );
+
+	git_commit* cmt = nullptr;
+	git_commit_lookup( &cmt, repo, &oid );
+	hash.resize( 8 );
+	git_oid_tostr( hash.data( ), 8, &oid );
+
+	git_commit_free( cmt );
+	git_repository_free( repo );
+	git_libgit2_shutdown( );
+
+	return hash;
+}
+
+// Создание и настройка компилятора
+CompilerInstance* createCompilerInstance( )
+{
+	auto* ci = new CompilerInstance( );
+	ci->createDiagnostics( );
+
+	auto targetOptions = std::make_shared< TargetOptions >( );
+
+	targetOptions->Triple = llvm::sys::getDefaultTargetTriple( );
+	targetOptions->CPU    = llvm::sys::getHostCPUName( ).str( );
+
+	ci->setTarget( TargetInfo::CreateTargetInfo( ci->getDiagnostics( ), targetOptions ) );
+
+	ci->createFileManager( );
+	ci->createSourceManager( ci->getFileManager( ) );
+	ci->createPreprocessor( TU_Complete );
+	ci->createASTContext( );
+
+	return ci;
+}
+
+// Настроенные компиляторы переиспользуются между вызовами generate( ): каждому вызову достаётся свой экземпляр со свежим ASTContext
+class CompilerPool
+{
+	std::mutex				 mutex_;
+	std::vector< std::unique_ptr< CompilerInstance > > free_;
+
+public:
+	class Lease
+	{
+		CompilerPool*			  pool_;
+		std::unique_ptr< CompilerInstance > ci_;
+
+	public:
+		Lease( CompilerPool* pool, std::unique_ptr< CompilerInstance > ci ) : pool_( pool ), ci_( std::move( ci ) )
+		{
+		}
+		Lease( Lease&& )	    = default;
+		Lease& operator=( Lease&& ) = default;
+
+		~Lease( )
+		{
+			if ( !ci_ ) return;
+			std::lock_guard lock( pool_->mutex_ );
+			pool_->free_.push_back( std::move( ci_ ) );
+		}
+
+		CompilerInstance* operator->( ) const
+		{
+			return ci_.get( );
+		}
+	};
+
+	Lease acquire( )
+	{
+		{
+			std::lock_guard lock( mutex_ );
+			if ( !free_.empty( ) ) {
+				auto ci = std::move( free_.back( ) );
+				free_.pop_back( );
+				ci->createASTContext( );
+				return { this, std::move( ci ) };
+			}
+		}
+		return { this, std::unique_ptr< CompilerInstance >( createCompilerInstance( ) ) };
+	}
+
+	static CompilerPool& instance( )
+	{
+		static CompilerPool pool;
+		return pool;
+	}
+};
+
+class TypeBuilder
+{
+public:
+	enum class Types : uint8_t
+	{
+		none = 0,
+
+		boolean = 1,
+
+		i8,
+		u8,
+
+		i16,
+		u16,
+
+		i32,
+		u32,
+
+		i64,
+		u64,
+
+		f32,
+		f64,
+
+		string,
+	};
+	using e_type = FIX8::conjure_enum< Types >;
+
+private:
+	ASTContext& ctx_;
+	bool	    x64_;
+
+public:
+	explicit TypeBuilder( ASTContext& context, const bool x64 = true ) : ctx_( context ), x64_( x64 )
+	{
+	}
+
+	[[nodiscard]] static std::string_view TypeName( const Types tp )
+	{
+		return e_type::enum_to_string( tp, true );
+	}
+	[[nodiscard]] static std::string_view TypeName( const numeric::Element el )
+	{
+		switch ( el ) {
+			case numeric::Element::i64: return TypeName( Types::i64 );
+			case numeric::Element::u64: return TypeName( Types::u64 );
+			case numeric::Element::f64:
+			default			  : return TypeName( Types::f64 );
+		}
+	}
+	// Обратное к GetType( ) для уже созданных переменных
+	[[nodiscard]] Types TypeOf( const QualType type ) const
+	{
+		if ( type->isBooleanType( ) ) return Types::boolean;
+		if ( type->isPointerType( ) ) return Types::string;
+		if ( type->isFloatingType( ) ) return ctx_.getTypeSize( type ) == 32 ? Types::f32 : Types::f64;
+		if ( type->isIntegerType( ) ) {
+			const bool sign = type->isSignedIntegerType( );
+			switch ( ctx_.getTypeSize( type ) ) {
+				case 8 : return sign ? Types::i8 : Types::u8;
+				case 16: return sign ? Types::i16 : Types::u16;
+				case 32: return sign ? Types::i32 : Types::u32;
+				default: return sign ? Types::i64 : Types::u64;
+			}
+		}
+		return Types::none;
+	}
+
+	[[nodiscard]] QualType GetType( const std::string_view typeName )
+	{
+		auto tp = e_type::unscoped_string_to_enum( typeName ).value_or( Types::none );
+		return GetType( tp );
+	}
+	[[nodiscard]] QualType GetType( const Types tp )
+	{
+		switch ( tp ) {
+			case Types::boolean: return ctx_.BoolTy;
+			case Types::i8	   : return ctx_.CharTy;
+			case Types::u8	   : return ctx_.UnsignedCharTy;
+			case Types::i16	   : return ctx_.ShortTy;
+			case Types::u16	   : return ctx_.UnsignedShortTy;
+
+			case Types::i32	   : return ctx_.IntTy;
+			case Types::u32	   : return ctx_.UnsignedIntTy;
+
+			case Types::i64	   : return x64_ ? ctx_.LongLongTy : ctx_.IntTy;
+			case Types::u64	   : return x64_ ? ctx_.UnsignedLongLongTy : ctx_.UnsignedIntTy;
+
+			case Types::f32	  : return ctx_.FloatTy;
+
+			case Types::f64	  : return ctx_.DoubleTy;
+
+			case Types::string: return ctx_.getPointerType( ctx_.CharTy );
+
+			case Types::none  :
+			default		  : throw std::logic_error( "[builder] Unknown type" );
+		}
+	}
+
+	Expr* BuildInitStatement( const Types tp, std::string_view init_state )
+	{
+
+		switch ( tp ) {
+			case Types::boolean: {
+
+				return CXXBoolLiteralExpr::Create( ctx_,
+								   !( init_state == "false" || init_state == "0" ),
+								   GetType( tp ),
+								   SourceLocation( ) );
+			}
+			case Types::u8:
+			case Types::i8: {
+				return clang::IntegerLiteral::Create( ctx_, llvm::APInt( 8, init_state, 10 ), GetType( tp ), SourceLocation( ) );
+			}
+			case Types::u16:
+			case Types::i16: {
+				return clang::IntegerLiteral::Create( ctx_, llvm::APInt( 16, init_state, 10 ), GetType( tp ), SourceLocation( ) );
+			}
+			case Types::u32:
+			case Types::i32: {
+
+				return clang::IntegerLiteral::Create( ctx_, llvm::APInt( 32, init_state, 10 ), GetType( tp ), SourceLocation( ) );
+			}
+			case Types::u64:
+			case Types::i64: {
+				return clang::IntegerLiteral::Create( ctx_, llvm::APInt( x64_ ? 64 : 32, init_state, 10 ), GetType( tp ), SourceLocation( ) );
+			}
+			case Types::f32: {
+				float xfl;
+				std::from_chars( &( *init_state.begin( ) ), &( *init_state.end( ) ), xfl );
+				return clang::FloatingLiteral::Create( ctx_, llvm::APFloat( xfl ), false, GetType( "f32" ), SourceLocation( ) );
+			}
+			case Types::f64: {
+				double xw;
+				std::from_chars( &( *init_state.begin( ) ), &( *init_state.end( ) ), xw );
+				return clang::FloatingLiteral::Create( ctx_, llvm::APFloat( xw ), false, GetType( "f64" ), SourceLocation( ) );
+			}
+			case Types::string: {
+				return clang::StringLiteral::Create( ctx_,
+								     init_state,
+								     StringLiteral::Unevaluated,
+								     false,
+								     ctx_.getStringLiteralArrayType( ctx_.CharTy, init_state.size( ) ),
+								     SourceLocation( ) );
+			}
+			default: {
+				// Обработка случая по умолчанию, если нужно
+				return nullptr;
+			}
+		}
+	}
+
+	// Литералы из уже разобранного значения, без повторного парсинга строки
+	Expr* BuildIntegerLiteral( const Types tp, const uint64_t value )
+	{
+		const QualType type = GetType( tp );
+		return clang::IntegerLiteral::Create( ctx_,
+						      llvm::APInt( ctx_.getIntWidth( type ), value, type->isSignedIntegerType( ) ),
+						      type,
+						      SourceLocation( ) );
+	}
+
+	Expr* BuildFloatingLiteral( const Types tp, const double value )
+	{
+		if ( tp == Types::f32 )
+			return clang::FloatingLiteral::Create( ctx_, llvm::APFloat( float( value ) ), false, GetType( tp ), SourceLocation( ) );
+		return clang::FloatingLiteral::Create( ctx_, llvm::APFloat( value ), false, GetType( tp ), SourceLocation( ) );
+	}
+};
+
+NamespaceDecl* CreateNamespace( llvm::StringRef name, ASTContext& ctx, DeclContext* dcctx )
+{
+	NamespaceDecl* ns_global
+			= NamespaceDecl::Create( ctx, dcctx, false, SourceLocation( ), SourceLocation( ), &ctx.Idents.get( name ), nullptr, true );
+
+	return ns_global;
+}
+
+void createVar( ASTContext& ctx, NamespaceDecl* ns, const llvm::StringRef name, const QualType type, Expr* init )
+{
+	VarDecl* varDecl = VarDecl::Create( ctx, ns, SourceLocation( ), SourceLocation( ), &ctx.Idents.get( name ), type, nullptr, SC_None );
+
+	varDecl->setConstexpr( true );
+	varDecl->setInit( init );
+
+	ns->addDecl( varDecl );
+}
+
+using json = jsoncons::json;
+
+namespace ConfParser {
+	uint32_t parse_version( const std::string_view& version_str )
+	{
+		llvm::Regex				version_pattern( R"((\d+)\.(\d+)\.(\d+))" );
+		llvm::SmallVector< llvm::StringRef, 4 > matches;
+
+		if ( version_pattern.match( version_str, &matches ) ) {
+			int major = std::stoi( matches[ 1 ].str( ) );
+			int minor = std::stoi( matches[ 2 ].str( ) );
+			int patch = std::stoi( matches[ 3 ].str( ) );
+
+			return VERSION_PACK( major, minor, patch );
+		}
+
+		return VERSION_PACK( 0, 0, 0 );
+	}
+
+	Project parse( const json& j )
+	{
+		Project project;
+
+		const auto& j_project = j[ "project" ];
+
+		project.name	    = j_project[ "name" ].as< std::string >( );
+		project.desc	    = j_project[ "desc" ].as< std::string >( );
+		project.output_path = j_project[ "output-path" ].as< std::string >( );
+		project.project_dir = j_project[ "project-dir" ].as< std::string >( );
+		project.version	    = parse_version( j_project[ "version" ].as< std::string >( ) );
+		project.debug	    = j_project[ "debug" ].as< bool >( );
+		project.dev	    = j_project[ "dev" ].as< bool >( );
+
+		return project;
+	}
+
+	void appendProjectNamespace( ASTContext& ctx, const Project& p, const cthpp::Options& options, NamespaceDecl* ns )
+	{
+		auto str_qt = TypeBuilder( ctx ).GetType( "string" );
+		createVar( ctx, ns, "name", str_qt, TypeBuilder( ctx ).BuildInitStatement( TypeBuilder::Types::string, p.name ) );
+		createVar( ctx, ns, "description", str_qt, TypeBuilder( ctx ).BuildInitStatement( TypeBuilder::Types::string, p.desc ) );
+		if ( !options.no_git && !options.stable )
+			createVar( ctx, ns, "git_hash", str_qt, TypeBuilder( ctx ).BuildInitStatement( TypeBuilder::Types::string, p.git_hash ) );
+		createVar( ctx,
+			   ns,
+			   "version",
+			   TypeBuilder( ctx ).GetType( "u32" ),
+			   TypeBuilder( ctx ).BuildInitStatement( TypeBuilder::Types::i32, std::to_string( p.version ) ) );
+		createVar( ctx,
+			   ns,
+			   "debug",
+			   TypeBuilder( ctx ).GetType( "boolean" ),
+			   TypeBuilder( ctx ).BuildInitStatement( TypeBuilder::Types::boolean, p.debug ? "true" : "false" ) );
+		createVar( ctx,
+			   ns,
+			   "release",
+			   TypeBuilder( ctx ).GetType( "boolean" ),
+			   TypeBuilder( ctx ).BuildInitStatement( TypeBuilder::Types::boolean, p.debug ? "false" : "true" ) );
+		createVar( ctx,
+			   ns,
+			   "development",
+			   TypeBuilder( ctx ).GetType( "boolean" ),
+			   TypeBuilder( ctx ).BuildInitStatement( TypeBuilder::Types::boolean, p.dev ? "true" : "false" ) );
+		createVar( ctx,
+			   ns,
+			   "production",
+			   TypeBuilder( ctx ).GetType( "boolean" ),
+			   TypeBuilder( ctx ).BuildInitStatement( TypeBuilder::Types::boolean, p.dev ? "false" : "true" ) );
+		if ( !options.stable )
+			createVar( ctx,
+				   ns,
+				   "target",
+				   str_qt,
+				   TypeBuilder( ctx ).BuildInitStatement( TypeBuilder::Types::string, p.current_build_cmake_target ) );
+		createVar( ctx, ns, "system", str_qt, TypeBuilder( ctx ).BuildInitStatement( TypeBuilder::Types::string, options.target_system ) );
+		createVar( ctx, ns, "arch", str_qt, TypeBuilder( ctx ).BuildInitStatement( TypeBuilder::Types::string, options.target_arch ) );
+		createVar( ctx, ns, "mode", str_qt, TypeBuilder( ctx ).BuildInitStatement( TypeBuilder::Types::string, p.mode ) );
+		createVar( ctx, ns, "type", str_qt, TypeBuilder( ctx ).BuildInitStatement( TypeBuilder::Types::string, p.build_type ) );
+	}
+
+	// --stable: поля, меняющиеся от коммита к коммиту, живут в отдельном заголовке
+	void appendBuildInfoNamespace( ASTContext& ctx, const Project& p, const cthpp::Options& options, NamespaceDecl* ns )
+	{
+		auto str_qt = TypeBuilder( ctx ).GetType( "string" );
+		if ( !options.no_git )
+			createVar( ctx, ns, "git_hash", str_qt, TypeBuilder( ctx ).BuildInitStatement( TypeBuilder::Types::string, p.git_hash ) );
+		createVar( ctx,
+			   ns,
+			   "target",
+			   str_qt,
+			   TypeBuilder( ctx ).BuildInitStatement( TypeBuilder::Types::string, p.current_build_cmake_target ) );
+	}
+
+	// Числовые массивы не попадают в AST: они собираются в tables и выводятся через numeric::emitTable
+	void parseJsonObject( const json&			root,
+			      ASTContext&			ctx,
+			      NamespaceDecl*			ns,
+			      const cthpp::Options&		options,
+			      std::vector< numeric::Table >&	tables,
+			      std::vector< reflection::Entry >& fields )
+	{
+
+		if ( root.is_object( ) ) {
+			for ( const auto& item : root.object_range( ) ) {
+				auto	    key	  = std::string( item.key( ) );
+				const auto& val	  = item.value( );
+				const auto  table = numeric::classify( val );
+				if ( val.is_object( ) || ( val.is_array( ) && !table ) ) {
+					NamespaceDecl* child_ns = CreateNamespace( key, ctx, ns );
+					parseJsonObject( val, ctx, child_ns, options, tables, fields );
+					ns->addDecl( child_ns );    // Добавляем декларант в родительский namespace
+				} else if ( table ) {
+					for ( auto pos = key.find( '-' ); pos != std::string::npos; pos = key.find( '-' ) ) key[ pos ] = '_';
+
+					tables.push_back( { ns->getQualifiedNameAsString( ), key, *table, &val } );
+					fields.push_back( { ns->getQualifiedNameAsString( ), key, std::string( TypeBuilder::TypeName( *table ) ), true } );
+				} else {
+					TypeBuilder::Types tp = TypeBuilder::Types::none;
+
+					switch ( val.type( ) ) {
+						case jsoncons::json_type::bool_value	   : tp = TypeBuilder::Types::boolean; break;
+						case jsoncons::json_type::string_value	   : tp = TypeBuilder::Types::string; break;
+						case jsoncons::json_type::byte_string_value: tp = TypeBuilder::Types::string; break;
+						case jsoncons::json_type::int64_value	   : tp = TypeBuilder::Types::i64; break;
+						case jsoncons::json_type::uint64_value	   : tp = TypeBuilder::Types::u64; break;
+						case jsoncons::json_type::double_value	   : tp = TypeBuilder::Types::f64; break;
+						default					   : break;
+					}
+
+					for ( auto pos = key.find( '-' ); pos != std::string::npos; pos = key.find( '-' ) ) key[ pos ] = '_';
+
+					TypeBuilder builder( ctx, options.target_arch == "x64" );
+					Expr*	    init;
+					switch ( tp ) {
+						case TypeBuilder::Types::i64:
+							init = builder.BuildIntegerLiteral( tp, static_cast< uint64_t >( val.as< int64_t >( ) ) );
+							break;
+						case TypeBuilder::Types::u64: init = builder.BuildIntegerLiteral( tp, val.as< uint64_t >( ) ); break;
+						case TypeBuilder::Types::f64: init = builder.BuildFloatingLiteral( tp, val.as< double >( ) ); break;
+						default			    : init = builder.BuildInitStatement( tp, val.as_string( ) ); break;
+					}
+
+					createVar( ctx, ns, key, builder.GetType( tp ), init );
+					fields.push_back( { ns->getQualifiedNameAsString( ), key, std::string( TypeBuilder::TypeName( tp ) ) } );
+				}
+			}
+		}
+	}
+
+}    // namespace ConfParser
+
+void copytight_show( llvm::raw_ostream& os )
+{
+	// GPL3 Lisence
+}
+
+cthpp::Result cthpp::generate( const Options& options, const std::string_view config )
+{
+	using namespace srilakshmikanthanp;
+
+	// Свой пустой поток на вызов: llvm::nulls( ) общий на процесс и буферизован, параллельные вызовы гонялись бы за его буфер
+	llvm::raw_null_ostream null_log;
+	llvm::raw_ostream&     log = options.log ? *options.log : null_log;
+
+	Options opts = options;
+	if ( opts.target_arch != "x86" ) opts.target_arch = "x64";
+
+	Result				     result;
+	ConfParser::Project&		     proj = result.project;
+	std::optional< CompilerPool::Lease > ci;
+	NamespaceDecl*			     ns_global_config = nullptr;
+	json				     config_json;
+	std::vector< numeric::Table >	     tables;
+	std::vector< reflection::Entry >     fields;
+	json				     schema_json;
+	std::vector< schema::Constraint >    constraints;
+	std::vector< std::string >	     schema_skipped;
+	std::unique_ptr< libfiglet::figlet > figlet_ProjectLogo;
+
+	// Фазы старта независимы друг от друга вплоть до построения AST
+	pipeline::TaskGraph startup;
+
+	const auto compiler = startup.add( "compiler", [ & ] { ci.emplace( CompilerPool::instance( ).acquire( ) ); } );
+
+	const auto parsed = startup.add( "json", [ & ] {
+		config_json = json::parse( config );
+		proj	    = ConfParser::parse( config_json );
+
+		if ( !opts.working_dir.empty( ) ) proj.project_dir = opts.working_dir;
+		if ( proj.project_dir.empty( ) ) {
+			llvm::SmallVector< char, 256 > path_data_raw;
+			const auto		       errc = llvm::sys::fs::current_path( path_data_raw );
+			proj.project_dir		    = { path_data_raw.data( ), path_data_raw.size( ) };
+		}
+
+		if ( opts.debug ) proj.debug = *opts.debug;
+		if ( opts.dev ) proj.dev = *opts.dev;
+		if ( !opts.output_path.empty( ) ) proj.output_path = opts.output_path;
+
+		proj.current_build_cmake_target = opts.cmake_target;
+
+		proj.build_type = proj.debug ? "debug" : "release";
+		proj.mode	= proj.dev ? "development" : "production";
+	} );
+
+	// project-dir берётся из конфига, поэтому git ждёт json
+	const auto git = startup.add(
+			"git",
+			[ & ] {
+				if ( opts.no_git ) return;
+				if ( opts.git_hash ) {
+					proj.git_hash = *opts.git_hash;
+					return;
+				}
+				proj.git_hash = getHashGitCommit( proj.project_dir, log );
+				if ( !proj.git_hash.empty( ) ) proj.git_hash.pop_back( );
+			},
+			{ parsed } );
+
+	if ( !opts.schema.empty( ) ) {
+		const auto schema_parsed = startup.add( "schema", [ & ] { schema_json = json::parse( opts.schema ); } );
+
+		startup.add(
+				"validate",
+				[ & ] {
+					schema::validate( schema_json, config_json );
+					schema::collect( schema_json, config_json[ "config" ], opts.global_namespace, constraints, schema_skipped );
+				},
+				{ parsed, schema_parsed } );
+	}
+
+	if ( !opts.font_dir.empty( ) && !opts.stable )
+		startup.add( "figlet", [ & ] {
+			figlet_ProjectLogo = std::make_unique< libfiglet::figlet >(
+					libfiglet::flf_font::make_shared( ( std::filesystem::path( opts.font_dir ) / "Standard.flf" ).string( ) ),
+					libfiglet::full_width::make_shared( ) );
+		} );
+
+	startup.add(
+			"ast",
+			[ & ] {
+				ASTContext&	     context	  = ( *ci )->getASTContext( );
+				TranslationUnitDecl* global_scope = context.getTranslationUnitDecl( );
+
+				// Создание пространства имен
+				ns_global_config		 = CreateNamespace( opts.global_namespace, context, global_scope );
+				NamespaceDecl* namespaceProject = CreateNamespace( "project", context, ns_global_config );
+
+				ConfParser::appendProjectNamespace( context, proj, opts, namespaceProject );
+
+				ns_global_config->addDecl( namespaceProject );
+
+				if ( opts.reflection )
+					for ( const auto* var : namespaceProject->decls( ) )
+						if ( const auto* vd = llvm::dyn_cast< VarDecl >( var ) )
+							fields.push_back( { namespaceProject->getQualifiedNameAsString( ),
+									    vd->getNameAsString( ),
+									    std::string( TypeBuilder::TypeName( TypeBuilder( context ).TypeOf( vd->getType( ) ) ) ) } );
+
+				ConfParser::parseJsonObject( config_json[ "config" ], context, ns_global_config, opts, tables, fields );
+
+				global_scope->addDecl( ns_global_config );
+			},
+			{ compiler, git } );
+
+	// Тайминги печатаются и при ошибке: тогда они нужнее всего
+	try {
+		startup.run( opts.concurrent_startup );
+	} catch ( ... ) {
+		if ( opts.timings ) startup.printTimings( log );
+		throw;
+	}
+
+	if ( opts.timings ) startup.printTimings( log );
+
+	// Фазы пишут в log параллельно, поэтому пропущенные ограничения печатаются после старта
+	for ( const auto& skipped : schema_skipped ) log << "[schema] no static_assert for " << skipped << " (checked at generation only)\n";
+
+	ASTContext&	     context	  = ( *ci )->getASTContext( );
+	TranslationUnitDecl* global_scope = context.getTranslationUnitDecl( );
+
+	// Вывод сгенерированного кода
+	LangOptions langOpts;
+
+	using e_lang_t = FIX8::conjure_enum< LangStandard::Kind >;
+
+	langOpts.LangStd = LangStandard::lang_cxx23;
+
+	if ( auto lang = e_lang_t::unscoped_string_to_enum( "lang_" + opts.std ); lang ) langOpts.LangStd = *lang;
+
+	PrintingPolicy policy( langOpts );
+	policy.Bool    = 1;
+	policy.MSWChar = 1;
+
+	// static_assert'ы схемы ссылаются на ключи, поэтому при --prune-using первый рендер для сканирования идёт без них.
+	// _meta остаётся: исходники могут использовать for_each и fields, а его собственные ссылки сканер пропускает
+	const auto renderHeader = [ & ]( const bool with_schema_asserts ) {
+		const bool with_reflection = opts.reflection;
+		const bool with_schema	   = with_schema_asserts && !constraints.empty( );
+
+		std::string		 config_impl;
+		llvm::raw_string_ostream os( config_impl );
+
+		copytight_show( os );
+
+		if ( figlet_ProjectLogo ) {
+			os << "/*\n";
+			os << ( *figlet_ProjectLogo )( proj.name ) << "\n";
+			os << "*/\n\n";
+		}
+
+		os << "#pragma once\n\n";
+
+		if ( with_reflection ) os << "#include <tuple>\n\n";
+
+		os << "#define VERSION_PACK(MAJOR, MINOR, PATCH) ( ( ( MAJOR ) << 16 ) | ( ( MINOR ) << 8 ) | ( PATCH ) )"
+		   << "\n\n\n";
+
+		global_scope->print( os, policy );
+
+		if ( !tables.empty( ) ) os << "\n\n";
+		for ( const auto& table : tables ) numeric::emitTable( os, table, opts.float_format );
+
+		if ( with_reflection ) {
+			os << "\n\n";
+			reflection::emit( os, opts.global_namespace, fields );
+		}
+
+		if ( with_schema ) {
+			os << "\n\n";
+			schema::emit( os, opts.global_namespace, constraints );
+		}
+
+		return os.str( );
+	};
+
+	std::string build_info_impl;
+	const auto  build_info_path = opts.build_info_path.empty( )
+					      ? ( std::filesystem::path( proj.output_path ).parent_path( ) / "conf_build_info.hpp" ).string( )
+					      : opts.build_info_path;
+
+	if ( opts.stable ) {
+		NamespaceDecl* ns_build_info   = CreateNamespace( opts.global_namespace, context, global_scope );
+		NamespaceDecl* ns_project_info = CreateNamespace( "project", context, ns_build_info );
+		ConfParser::appendBuildInfoNamespace( context, proj, opts, ns_project_info );
+		ns_build_info->addDecl( ns_project_info );
+
+		llvm::raw_string_ostream bos( build_info_impl );
+		bos << "#pragma once\n\n";
+		ns_build_info->print( bos, policy );
+		bos << "\n";
+	}
+
+	std::string config_impl = renderHeader( opts.prune_using.empty( ) );
+
+	if ( !opts.prune_using.empty( ) ) {
+		const auto absolute = []( const std::string& path ) {
+			llvm::SmallString< 256 > abs( path );
+			llvm::sys::fs::make_absolute( abs );
+			llvm::sys::path::remove_dots( abs, true );
+			return std::string( abs );
+		};
+
+		// Исходники разбираются с полным заголовком в памяти, даже если на диске лежит прошлый урезанный
+		std::vector< usage::VirtualFile > headers{ { absolute( proj.output_path ), config_impl } };
+		if ( opts.stable ) headers.push_back( { absolute( build_info_path ), build_info_impl } );
+
+		const auto scanned = usage::scan( opts.prune_using,
+						  std::filesystem::path( headers.front( ).path ).parent_path( ).string( ),
+						  headers,
+						  opts.global_namespace,
+						  opts.usage_cache_path.empty( ) ? proj.output_path + ".usage.json" : opts.usage_cache_path,
+						  log );
+
+		// Ссылки не скомпилировавшихся файлов неполны: урезанный заголовок сломал бы сборку таргета
+		if ( !scanned )
+			log << "[prune] not pruning: some sources failed to compile, emitting the full header\n";
+		else {
+			const auto& used = *scanned;
+
+			std::vector< std::string > unused;
+			usage::prune( ns_global_config, used, unused );
+			std::erase_if( tables, [ & ]( const numeric::Table& table ) {
+				auto name = table.scope + "::" + table.name;
+				if ( used.contains( name ) ) return false;
+				unused.push_back( std::move( name ) );
+				return true;
+			} );
+
+			log << "[prune] " << used.size( ) << " keys used, " << unused.size( ) << " unused:\n";
+			for ( const auto& name : unused ) log << "\t" << name << "\n";
+
+			std::erase_if( fields, [ & ]( const reflection::Entry& field ) { return !used.contains( field.scope + "::" + field.name ); } );
+			std::erase_if( constraints, [ & ]( const schema::Constraint& constraint ) { return !used.contains( constraint.path ); } );
+		}
+
+		config_impl = renderHeader( true );
+	}
+
+	result.headers.push_back( { proj.output_path, std::move( config_impl ) } );
+	if ( opts.stable ) result.headers.push_back( { build_info_path, std::move( build_info_impl ) } );
+
+	return result;
+}
@@ -0,0 +1,105 @@
+// GPL3 lisence
+//
+// Created by @olokreaz on 19.10.2026.
+//
+
+#ifndef CTHPP_HPP
+#define CTHPP_HPP
+
+#include <llvm/Support/raw_ostream.h>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "./numeric_table.hpp"
+
+#define VERSION_PACK( MAJOR, MINOR, PATCH ) ( ( ( MAJOR ) << 16 ) | ( ( MINOR ) << 8 ) | ( PATCH ) )
+#define VERSION_MAJOR( VERSION )	    ( ( ( VERSION ) >> 16 ) & 0xFF )
+#define VERSION_MINOR( VERSION )	    ( ( ( VERSION ) >> 8 ) & 0xFF )
+#define VERSION_PATCH( VERSION )	    ( ( VERSION ) & 0xFF )
+
+namespace ConfParser {
+	struct Project
+	{
+		std::string name;
+		std::string desc;
+		std::string git_hash;
+		bool	    has_uncommited_changes{ false };
+
+		uint32_t version{ VERSION_PACK( 1, 0, 0 ) };	// MAJOR.MINOR.PATCH
+		bool	 debug{ false };			// debug = debug | !debug = release
+		bool	 dev{ true };				// development = development | !development = production
+
+		std::string build_type;				// build type (debug, release)
+		std::string mode;				// build mode (development, production)
+		std::string current_build_cmake_target;		// current build target game-client | game-server | engine-client | engine-server
+
+		// system params
+
+		std::string output_path;
+		std::string project_dir;
+	};
+}    // namespace ConfParser
+
+// Встраиваемый генератор: без глобального состояния cl::opt, можно вызывать из нескольких потоков одновременно
+namespace cthpp {
+
+	// Аналоги опций командной строки cth++
+	struct Options
+	{
+		std::string global_namespace{ "config" };
+		std::string cmake_target{ "none" };
+		std::string target_system{ "none" };
+		std::string target_arch{ "x64" };
+		std::string std{ "std23" };
+
+		std::string working_dir;		     // вместо project.project-dir
+		std::string output_path{ "./conf.hpp" };    // вместо project.output-path, пустой - значение из конфига
+
+		std::optional< bool > debug;		     // вместо project.debug
+		std::optional< bool > dev;		     // вместо project.dev
+
+		bool			   no_git{ false };
+		std::optional< std::string > git_hash;	     // без libgit2, готовый хеш
+
+		std::string font_dir;			     // каталог со Standard.flf для баннера, пустой - без баннера
+
+		bool	    stable{ false };
+		std::string build_info_path;		     // по умолчанию <каталог вывода>/conf_build_info.hpp
+
+		std::string prune_using;		     // compile_commands.json
+		std::string usage_cache_path;		     // кеш сканирования по файлам, по умолчанию <output path>.usage.json
+
+		numeric::FloatFormat float_format{ numeric::FloatFormat::shortest };
+
+		bool reflection{ false };    // constexpr <namespace>::_meta::fields и for_each
+
+		std::string schema;	     // текст JSON Schema: проверка и static_assert по ограниченным ключам, пустой - выключено
+
+		bool concurrent_startup{ true };    // false - фазы выполняются в вызывающем потоке, без потоков на каждый вызов
+
+		bool		   timings{ false };
+		llvm::raw_ostream* log{ nullptr };	     // тайминги и отчёты, nullptr - без вывода
+	};
+
+	struct Header
+	{
+		std::string path;
+		std::string content;
+	};
+
+	struct Result
+	{
+		ConfParser::Project   project;
+		std::vector< Header > headers;	  // основной заголовок, затем build info в режиме stable
+	};
+
+	// Рендерит заголовки из JSON-конфига в памяти. На диск пишется только кеш сканирования при prune_using, поэтому
+	// параллельные вызовы с prune_using должны использовать разные usage_cache_path
+	Result generate( const Options& options, std::string_view config );
+}    // namespace cthpp
+
+#endif	  //CTHPP_HPP
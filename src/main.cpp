@@ -1,106 +1,30 @@
 // GPL3 lisence
 
 
-#include <clang/AST/AST.h>
-#include <clang/AST/ASTContext.h>
-#include <clang/AST/Decl.h>
-#include <clang/AST/DeclCXX.h>
-#include <clang/AST/PrettyPrinter.h>
-#include <clang/Basic/Diagnostic.h>
-#include <clang/Basic/FileManager.h>
-#include <clang/Basic/SourceManager.h>
-#include <clang/Basic/TargetInfo.h>
-#include <clang/Frontend/ASTConsumers.h>
-#include <clang/Frontend/ASTUnit.h>
-#include <clang/Frontend/CompilerInstance.h>
-#include <clang/Frontend/FrontendActions.h>
-#include <clang/Frontend/Utils.h>
-#include <clang/Tooling/Tooling.h>
-
-#include <llvm/ADT/APFixedPoint.h>
-#include <llvm/Support/Host.h>
-
-#include <conjure_enum.hpp>
+#include <llvm/Support/CommandLine.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Format.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
 
 #include <algorithm>
+#include <chrono>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
-#include <variant>
-
-#include <git2.h>
+#include <iterator>
+#include <optional>
+#include <sstream>
 
 #include <jsoncons/json.hpp>
-#include <jsoncons_ext/jsonpath/json_query.hpp>
 
 #include <srilakshmikanthanp/libfiglet.hpp>
 
-#include <llvm/Support/Regex.h>
-
-#define VERSION_PACK( MAJOR, MINOR, PATCH ) ( ( ( MAJOR ) << 16 ) | ( ( MINOR ) << 8 ) | ( PATCH ) )
-#define VERSION_MAJOR( VERSION )	    ( ( ( VERSION ) >> 16 ) & 0xFF )
-#define VERSION_MINOR( VERSION )	    ( ( ( VERSION ) >> 8 ) & 0xFF )
-#define VERSION_PATCH( VERSION )	    ( ( VERSION ) & 0xFF )
-
-using namespace clang;
-
+#include "./cthpp.hpp"
 #include "./program_options.hpp"
+#include "./watch.hpp"
 
-std::string getHashGitCommit( const llvm::StringRef path = "" )
-{
-	if ( opt::NoGit ) return "";
-
-	static std::string hash;
-	if ( !hash.empty( ) ) return hash;
-
-	if ( path.empty( ) ) return "";
-
-	git_libgit2_init( );
-
-	git_repository* repo = nullptr;
-
-	if ( const int er = git_repository_open( &repo, path.data( ) ); er ) {
-		git_libgit2_shutdown( );
-		const git_error* err = giterr_last( );
-		llvm::errs( ) << "git error " << er << " " << ( err && err->message ? err->message : "Uknown error" ) << "\n";
-		return { };
-	}
-
-	git_oid oid;
-	git_reference_name_to_id( &oid, repo, "HEAD" );
-
-	git_commit* cmt = nullptr;
-	git_commit_lookup( &cmt, repo, &oid );
-	hash.resize( 8 );
-	git_oid_tostr( hash.data( ), 8, &oid );
-
-	git_commit_free( cmt );
-	git_repository_free( repo );
-	git_libgit2_shutdown( );
-
-	return hash;
-}
-
-// Создание и настройка компилятора
-CompilerInstance* createCompilerInstance( )
-{
-	auto* ci = new CompilerInstance( );
-	ci->createDiagnostics( );
-
-	auto targetOptions = std::make_shared< TargetOptions >( );
-
-	targetOptions->Triple = llvm::sys::getDefaultTargetTriple( );
-	targetOptions->CPU    = llvm::sys::getHostCPUName( ).str( );
-
-	ci->setTarget( TargetInfo::CreateTargetInfo( ci->getDiagnostics( ), targetOptions ) );
-
-	ci->createFileManager( );
-	ci->createSourceManager( ci->getFileManager( ) );
-	ci->createPreprocessor( TU_Complete );
-	ci->createASTContext( );
-
-	return ci;
-}
+using json = jsoncons::json;
 
 namespace common {
 	constexpr size_t const_hash( const std::string_view input )
@@ -109,150 +33,58 @@ namespace common {
 	}
 }    // namespace common
 
-class TypeBuilder
-{
-public:
-	enum class Types : uint8_t
-	{
-		none = 0,
-
-		boolean = 1,
-
-		i8,
-		u8,
-
-		i16,
-		u16,
-
-		i32,
-		u32,
-
-		i64,
-		u64,
-
-		f32,
-		f64,
-
-		string,
-	};
-	using e_type = FIX8::conjure_enum< Types >;
-
-private:
-	ASTContext& ctx_;
-
-public:
-	explicit TypeBuilder( ASTContext& context ) : ctx_( context )
-	{
-	}
-
-	[[nodiscard]] QualType GetType( const std::string_view typeName )
-	{
-		auto tp = e_type::unscoped_string_to_enum( typeName ).value_or( Types::none );
-		return GetType( tp );
-	}
-	[[nodiscard]] QualType GetType( const Types tp )
-	{
-		switch ( tp ) {
-			case Types::boolean: return ctx_.BoolTy;
-			case Types::i8	   : return ctx_.CharTy;
-			case Types::u8	   : return ctx_.UnsignedCharTy;
-			case Types::i16	   : return ctx_.ShortTy;
-			case Types::u16	   : return ctx_.UnsignedShortTy;
-
-			case Types::i32	   : return ctx_.IntTy;
-			case Types::u32	   : return ctx_.UnsignedIntTy;
+#include <fmt/format.h>
+#include <filesystem>
 
-			case Types::i64	   : return common::const_hash( opt::TargetArch ) == common::const_hash( "x64" ) ? ctx_.LongLongTy : ctx_.IntTy;
-			case Types::u64:
-				return common::const_hash( opt::TargetArch ) == common::const_hash( "x64" ) ? ctx_.UnsignedLongLongTy
-													    : ctx_.UnsignedIntTy;
+std::string convertToUnixStyle( std::string path )
+{
+	std::replace( path.begin( ), path.end( ), '\\', '/' );
+	return path;
+}
 
-			case Types::f32	  : return ctx_.FloatTy;
+// Файл не перезаписывается, если содержимое не изменилось: mtime остаётся прежним и make/ninja не пересобирают зависимых
+bool writeIfChanged( const std::string& path, const llvm::StringRef content )
+{
+	if ( auto existing = llvm::MemoryBuffer::getFile( path, false, false ); existing && ( *existing )->getBuffer( ) == content )
+		return false;
 
-			case Types::f64	  : return common::const_hash( opt::TargetArch ) == common::const_hash( "x64" ) ? ctx_.DoubleTy : ctx_.FloatTy;
+	llvm::sys::fs::create_directories( std::filesystem::path( path ).parent_path( ).string( ) );
 
-			case Types::string: return ctx_.getPointerType( ctx_.CharTy );
+	std::error_code	     ec;
+	llvm::raw_fd_ostream of( path, ec );
+	if ( ec ) throw std::runtime_error( "can't write " + path + ": " + ec.message( ) );
 
-			case Types::none  :
-			default		  : throw std::logic_error( "[builder] Unknown type" );
-		}
-	}
+	of << content;
+	return true;
+}
 
-	Expr* BuildInitStatement( const Types tp, std::string_view init_state )
-	{
+std::optional< std::string > readFile( const std::string& path )
+{
+	std::ifstream file( path, std::ios::in | std::ios::binary );
+	if ( !file ) return std::nullopt;
+	return std::string( ( std::istreambuf_iterator< char >( file ) ), std::istreambuf_iterator< char >( ) );
+}
 
-		switch ( tp ) {
-			case Types::boolean: {
-
-				return CXXBoolLiteralExpr::Create( ctx_,
-								   !( init_state == "false" || init_state == "0" ),
-								   GetType( tp ),
-								   SourceLocation( ) );
-			}
-			case Types::u8:
-			case Types::i8: {
-				return clang::IntegerLiteral::Create( ctx_, llvm::APInt( 8, init_state, 10 ), GetType( tp ), SourceLocation( ) );
-			}
-			case Types::u16:
-			case Types::i16: {
-				return clang::IntegerLiteral::Create( ctx_, llvm::APInt( 16, init_state, 10 ), GetType( tp ), SourceLocation( ) );
-			}
-			case Types::u32:
-			case Types::i32: {
-
-				return clang::IntegerLiteral::Create( ctx_, llvm::APInt( 32, init_state, 10 ), GetType( tp ), SourceLocation( ) );
-			}
-			case Types::u64:
-			case Types::i64: {
-				return clang::IntegerLiteral::Create(
-						ctx_,
-						llvm::APInt( common::const_hash( opt::TargetArch ) == common::const_hash( "x64" ) ? 64 : 32,
-							     init_state,
-							     10 ),
-						GetType( tp ),
-						SourceLocation( ) );
-			}
-			case Types::f32: {
-				float xfl;
-				std::from_chars( &( *init_state.begin( ) ), &( *init_state.end( ) ), xfl );
-				return clang::FloatingLiteral::Create( ctx_, llvm::APFloat( xfl ), false, GetType( "f32" ), SourceLocation( ) );
-			}
-			case Types::f64: {
-				double xw;
-				std::from_chars( &( *init_state.begin( ) ), &( *init_state.end( ) ), xw );
-				return clang::FloatingLiteral::Create( ctx_, llvm::APFloat( xw ), false, GetType( "f64" ), SourceLocation( ) );
-			}
-			case Types::string: {
-				return clang::StringLiteral::Create( ctx_,
-								     init_state,
-								     StringLiteral::Unevaluated,
-								     false,
-								     ctx_.getStringLiteralArrayType( ctx_.CharTy, init_state.size( ) ),
-								     SourceLocation( ) );
-			}
-			default: {
-				// Обработка случая по умолчанию, если нужно
-				return nullptr;
-			}
-		}
-	}
-};
+// Путь к исполняемому файлу cth++; адрес локальной переменной вместо &main, который нельзя неявно привести к void*
+std::string executablePath( const char* argv0 )
+{
+	static int anchor = 0;
+	return llvm::sys::fs::getMainExecutable( argv0, &anchor );
+}
 
-NamespaceDecl* CreateNamespace( llvm::StringRef name, ASTContext& ctx, DeclContext* dcctx )
+// Файлы, от которых зависит git_hash: HEAD и ref текущей ветки
+std::vector< std::string > gitWatchFiles( const std::string& project_dir )
 {
-	NamespaceDecl* ns_global
-			= NamespaceDecl::Create( ctx, dcctx, false, SourceLocation( ), SourceLocation( ), &ctx.Idents.get( name ), nullptr, true );
+	if ( opt::NoGit || project_dir.empty( ) ) return { };
 
-	return ns_global;
-}
+	const auto		   git_dir = std::filesystem::path( project_dir ) / ".git";
+	std::vector< std::string > files{ ( git_dir / "HEAD" ).string( ), ( git_dir / "packed-refs" ).string( ) };
 
-#include <fmt/format.h>
-#include <filesystem>
+	std::ifstream head( git_dir / "HEAD" );
+	if ( std::string line; std::getline( head, line ) && line.starts_with( "ref: " ) )
+		files.push_back( ( git_dir / line.substr( 5 ) ).string( ) );
 
-std::string convertToUnixStyle( std::string path )
-{
-	std::replace( path.begin( ), path.end( ), '\\', '/' );
-	return path;
+	return files;
 }
 
 std::string CreateConfig( const std::string& name )
@@ -285,7 +117,7 @@ std::string CreateConfig( const std::string& name )
 	return ( std::filesystem::current_path( ) / ( name + ".json" ) ).string( );
 }
 
-void createCmakeScript( )
+void createCmakeScript( const std::string& executable )
 {
 	std::ofstream of( std::filesystem::current_path( ) / "cth-config.cmake", std::ios::out | std::ios::binary | std::ios::trunc );
 
@@ -295,7 +127,7 @@ void createCmakeScript( )
 	}
 
 	std::ostringstream oss;
-	oss << "set (CTHPP \"" << convertToUnixStyle( std::string( *__argv ) ) << "\")\n\n"
+	oss << "set (CTHPP \"" << convertToUnixStyle( executable ) << "\")\n\n"
 	    << R"(	function ( add_target_config )
 		set( options CONFIG NAMESPACE WORKING_DIR TYPE MODE TARGET OUTPUT )
 		cmake_parse_arguments( CONFIG "" "${options}" "" ${ARGN} )
@@ -392,160 +224,6 @@ void createCmakeScript( )
 	of.close( );
 }
 
-void createVar( ASTContext& ctx, NamespaceDecl* ns, const llvm::StringRef name, const QualType type, Expr* init )
-{
-	VarDecl* varDecl = VarDecl::Create( ctx, ns, SourceLocation( ), SourceLocation( ), &ctx.Idents.get( name ), type, nullptr, SC_None );
-
-	varDecl->setConstexpr( true );
-	varDecl->setInit( init );
-
-	ns->addDecl( varDecl );
-}
-
-using json = jsoncons::json;
-
-namespace ConfParser {
-	struct Project
-	{
-		std::string name;
-		std::string desc;
-		std::string git_hash;
-		bool	    has_uncommited_changes{ false };
-
-		uint32_t version{ VERSION_PACK( 1, 0, 0 ) };	// MAJOR.MINOR.PATCH
-		bool	 debug{ false };			// debug = debug | !debug = release
-		bool	 dev{ true };				// development = development | !development = production
-
-		std::string build_type;				// build type (debug, release)
-		std::string mode;				// build mode (development, production)
-		std::string current_build_cmake_target;		// current build target game-client | game-server | engine-client | engine-server
-
-		// system params
-
-		std::string output_path;
-		std::string project_dir;
-	};
-
-	uint32_t parse_version( const std::string_view& version_str )
-	{
-		llvm::Regex				version_pattern( R"((\d+)\.(\d+)\.(\d+))" );
-		llvm::SmallVector< llvm::StringRef, 4 > matches;
-
-		if ( version_pattern.match( version_str, &matches ) ) {
-			int major = std::stoi( matches[ 1 ].str( ) );
-			int minor = std::stoi( matches[ 2 ].str( ) );
-			int patch = std::stoi( matches[ 3 ].str( ) );
-
-			return VERSION_PACK( major, minor, patch );
-		}
-
-		return VERSION_PACK( 0, 0, 0 );
-	}
-
-	Project parse( const json& j )
-	{
-		Project project;
-
-		const auto& j_project = j[ "project" ];
-
-		project.name	    = j_project[ "name" ].as< std::string >( );
-		project.desc	    = j_project[ "desc" ].as< std::string >( );
-		project.output_path = j_project[ "output-path" ].as< std::string >( );
-		project.project_dir = j_project[ "project-dir" ].as< std::string >( );
-		project.version	    = parse_version( j_project[ "version" ].as< std::string >( ) );
-		project.debug	    = j_project[ "debug" ].as< bool >( );
-		project.dev	    = j_project[ "dev" ].as< bool >( );
-
-		return project;
-	}
-
-	void appendProjectNamespace( ASTContext& ctx, const Project& p, NamespaceDecl* ns )
-	{
-		auto str_qt = TypeBuilder( ctx ).GetType( "string" );
-		createVar( ctx, ns, "name", str_qt, TypeBuilder( ctx ).BuildInitStatement( TypeBuilder::Types::string, p.name ) );
-		createVar( ctx, ns, "description", str_qt, TypeBuilder( ctx ).BuildInitStatement( TypeBuilder::Types::string, p.desc ) );
-		if ( !opt::NoGit )
-			createVar( ctx, ns, "git_hash", str_qt, TypeBuilder( ctx ).BuildInitStatement( TypeBuilder::Types::string, p.git_hash ) );
-		createVar( ctx,
-			   ns,
-			   "version",
-			   TypeBuilder( ctx ).GetType( "u32" ),
-			   TypeBuilder( ctx ).BuildInitStatement( TypeBuilder::Types::i32, std::to_string( p.version ) ) );
-		createVar( ctx,
-			   ns,
-			   "debug",
-			   TypeBuilder( ctx ).GetType( "boolean" ),
-			   TypeBuilder( ctx ).BuildInitStatement( TypeBuilder::Types::boolean, p.debug ? "true" : "false" ) );
-		createVar( ctx,
-			   ns,
-			   "release",
-			   TypeBuilder( ctx ).GetType( "boolean" ),
-			   TypeBuilder( ctx ).BuildInitStatement( TypeBuilder::Types::boolean, p.debug ? "false" : "true" ) );
-		createVar( ctx,
-			   ns,
-			   "development",
-			   TypeBuilder( ctx ).GetType( "boolean" ),
-			   TypeBuilder( ctx ).BuildInitStatement( TypeBuilder::Types::boolean, p.dev ? "true" : "false" ) );
-		createVar( ctx,
-			   ns,
-			   "production",
-			   TypeBuilder( ctx ).GetType( "boolean" ),
-			   TypeBuilder( ctx ).BuildInitStatement( TypeBuilder::Types::boolean, p.dev ? "false" : "true" ) );
-		createVar( ctx,
-			   ns,
-			   "target",
-			   str_qt,
-			   TypeBuilder( ctx ).BuildInitStatement( TypeBuilder::Types::string, p.current_build_cmake_target ) );
-		createVar( ctx, ns, "system", str_qt, TypeBuilder( ctx ).BuildInitStatement( TypeBuilder::Types::string, opt::TargetSystem ) );
-		createVar( ctx, ns, "arch", str_qt, TypeBuilder( ctx ).BuildInitStatement( TypeBuilder::Types::string, opt::TargetArch ) );
-		createVar( ctx, ns, "mode", str_qt, TypeBuilder( ctx ).BuildInitStatement( TypeBuilder::Types::string, p.mode ) );
-		createVar( ctx, ns, "type", str_qt, TypeBuilder( ctx ).BuildInitStatement( TypeBuilder::Types::string, p.build_type ) );
-	}
-
-	void parseJsonObject( const json& root, ASTContext& ctx, NamespaceDecl* ns )
-	{
-
-		if ( root.is_object( ) ) {
-			for ( const auto& item : root.object_range( ) ) {
-				auto	    key = std::string( item.key( ) );
-				const auto& val = item.value( );
-				if ( val.is_object( ) || val.is_array( ) ) {
-					NamespaceDecl* child_ns = CreateNamespace( key, ctx, ns );
-					parseJsonObject( val, ctx, child_ns );
-					ns->addDecl( child_ns );    // Добавляем декларант в родительский namespace
-				} else {
-					TypeBuilder::Types tp = TypeBuilder::Types::none;
-
-					switch ( val.type( ) ) {
-						case jsoncons::json_type::bool_value	   : tp = TypeBuilder::Types::boolean; break;
-						case jsoncons::json_type::string_value	   : tp = TypeBuilder::Types::string; break;
-						case jsoncons::json_type::byte_string_value: tp = TypeBuilder::Types::string; break;
-						case jsoncons::json_type::int64_value	   : tp = TypeBuilder::Types::i64; break;
-						case jsoncons::json_type::uint64_value	   : tp = TypeBuilder::Types::u64; break;
-						case jsoncons::json_type::double_value	   : tp = TypeBuilder::Types::f64; break;
-						default					   : break;
-					}
-
-					for ( auto pos = key.find( '-' ); pos != std::string::npos; pos = key.find( '-' ) ) key[ pos ] = '_';
-
-					createVar( ctx,
-						   ns,
-						   key,
-						   TypeBuilder( ctx ).GetType( tp ),
-						   TypeBuilder( ctx ).BuildInitStatement( tp,
-											  val.as_string( ) ) );	   // Вызов пользовательской функции
-				}
-			}
-		}
-	}
-
-}    // namespace ConfParser
-
-void copytight_show( llvm::raw_ostream& os )
-{
-	// GPL3 Lisence
-}
-
 #include <stacktrace>
 
 #ifdef WIN32
@@ -616,7 +294,9 @@ void __se_translator( uint32_t code, EXCEPTION_POINTERS* pExp )
 
 int main( int argc, char** argv )
 {
+#ifdef WIN32
 	_set_se_translator( &__se_translator );
+#endif
 
 	const auto cbVersion = []( auto& os ) { os << "cth++ version 1.0.0\n"; };
 	cl::SetVersionPrinter( cbVersion );
@@ -626,9 +306,25 @@ int main( int argc, char** argv )
 
 	cl::ParseCommandLineOptions( argc, argv );
 
+	if ( opt::BenchNumeric ) {
+		numeric::benchmark( llvm::outs( ), opt::BenchNumeric, opt::FloatFormat );
+		return 0;
+	}
+
+	if ( opt::ConfigFile.empty( ) ) {
+		llvm::errs( ) << "Error: --config=<path> is required\n";
+		return -1;
+	}
+
+	// --watch не возвращается, а перезапись конфига из цикла сама бы вызывала перегенерацию
+	if ( opt::Watch && opt::RewriteConfig ) {
+		llvm::errs( ) << "Error: --rewrite-config cannot be combined with --watch\n";
+		return -1;
+	}
+
 	if ( opt::CreateConfig ) {
 		auto cfg_path = CreateConfig( opt::ConfigFile );
-		if ( opt::WithCmake ) createCmakeScript( );
+		if ( opt::WithCmake ) createCmakeScript( executablePath( *argv ) );
 		return 0;
 	}
 
@@ -638,102 +334,127 @@ int main( int argc, char** argv )
 		default				: opt::TargetArch = "x64"; break;
 	}
 
-	CompilerInstance*    ci		  = createCompilerInstance( );
-	ASTContext&	     context	  = ci->getASTContext( );
-	TranslationUnitDecl* global_scope = context.getTranslationUnitDecl( );
-
-	// Создание пространства имен
-	NamespaceDecl* ns_global_config = CreateNamespace( opt::GlobalNamespace, context, global_scope );
-
-	NamespaceDecl* namespaceProject = CreateNamespace( "project", context, ns_global_config );
-
-	ConfParser::Project proj;
-
 	try {
 
-		std::ifstream file( opt::ConfigFile );
-		if ( !file ) {
+		const auto config = readFile( opt::ConfigFile );
+		if ( !config ) {
 			llvm::errs( ) << "Error: file not found: " << opt::ConfigFile;
 			return -1;
 		}
-		auto json = json::parse( file );
-		proj	  = ConfParser::parse( json );
-
-		if ( !opt::WorkingDir.empty( ) ) proj.project_dir = opt::WorkingDir;
-		if ( proj.project_dir.empty( ) ) {
-			llvm::SmallVector< char, 256 > path_data_raw;
-			const auto		       errc = llvm::sys::fs::current_path( path_data_raw );
-			proj.project_dir		    = { path_data_raw.data( ), path_data_raw.size( ) };
-		}
-
-		if ( opt::Debug || opt::Release ) proj.debug = opt::Debug && !opt::Release;
-		if ( opt::Development || opt::Production ) proj.dev = opt::Development && !opt::Production;
-		if ( !opt::OutputPath.empty( ) ) proj.output_path = opt::OutputPath;
-
-		proj.current_build_cmake_target = opt::CmakeTarget;
-
-		proj.build_type = proj.debug ? "debug" : "release";
-		proj.mode	= proj.dev ? "development" : "production";
-		proj.git_hash	= getHashGitCommit( proj.project_dir );
-
-		if ( !proj.git_hash.empty( ) ) proj.git_hash.pop_back( );
-
-		ConfParser::appendProjectNamespace( context, proj, namespaceProject );
-
-		ns_global_config->addDecl( namespaceProject );
-
-		ConfParser::parseJsonObject( json[ "config" ], context, ns_global_config );
-
-		global_scope->addDecl( ns_global_config );
-
-		// Вывод сгенерированного кода
-		LangOptions langOpts;
 
-		using e_lang_t = FIX8::conjure_enum< LangStandard::Kind >;
-
-		langOpts.LangStd = LangStandard::lang_cxx23;
-
-		if ( auto lang = e_lang_t::unscoped_string_to_enum( "lang_" + opt::Std ); lang ) langOpts.LangStd = *lang;
-
-		PrintingPolicy policy( langOpts );
-		policy.Bool    = 1;
-		policy.MSWChar = 1;
-
-		using namespace srilakshmikanthanp;
-
-		const auto execdir = std::filesystem::path( llvm::sys::fs::getMainExecutable( *argv, &main ) ).parent_path( );
-
-		libfiglet::figlet figlet_copyright( libfiglet::flf_font::make_shared( ( execdir / "Ivrit.flf" ).string( ) ),
-						    libfiglet::full_width::make_shared( ) );
-
-		libfiglet::figlet figlet_ProjectLogo( libfiglet::flf_font::make_shared( ( execdir / "Standard.flf" ).string( ) ),
-						      libfiglet::full_width::make_shared( ) );
-
-		// std::string		 config_impl;
-		// llvm::raw_string_ostream os( config_impl );
-
-		llvm::sys::fs::create_directories( std::filesystem::path( proj.output_path ).parent_path( ).string( ) );
-
-		std::error_code	    ec;
-		llvm::raw_fd_stream os( proj.output_path, ec );
-
-		if ( !opt::NoLogo ) llvm::outs( ) << "\n" << figlet_ProjectLogo( "cth++" ) << "\n";
-
-		copytight_show( os );
-
-		os << "/*\n";
-		os << figlet_ProjectLogo( proj.name ) << "\n";
-		os << "*/\n\n";
+		const auto schema = opt::Schema.empty( ) ? std::optional< std::string >( "" ) : readFile( opt::Schema );
+		if ( !schema ) {
+			llvm::errs( ) << "Error: file not found: " << opt::Schema;
+			return -1;
+		}
 
-		os << "#pragma once\n\n";
+		const auto execdir = std::filesystem::path( executablePath( *argv ) ).parent_path( );
+
+		cthpp::Options options;
+		options.global_namespace = opt::GlobalNamespace;
+		options.cmake_target	 = opt::CmakeTarget;
+		options.target_system	 = opt::TargetSystem;
+		options.target_arch	 = opt::TargetArch;
+		options.std		 = opt::Std;
+		options.working_dir	 = opt::WorkingDir;
+		options.output_path	 = opt::OutputPath;
+		if ( opt::Debug || opt::Release ) options.debug = opt::Debug && !opt::Release;
+		if ( opt::Development || opt::Production ) options.dev = opt::Development && !opt::Production;
+		options.no_git		= opt::NoGit;
+		options.font_dir	= execdir.string( );
+		options.stable		= opt::Stable;
+		options.build_info_path = opt::BuildInfoPath;
+		options.prune_using	= opt::PruneUsing;
+		options.float_format	= opt::FloatFormat;
+		options.reflection	= opt::Reflection;
+		options.schema		= *schema;
+		options.timings		= opt::Timings;
+		options.log		= &llvm::outs( );
+
+		// Логотип печатается после generate( ): шрифт для заголовка грузится фазой figlet параллельно с остальным стартом,
+		// и загрузка ещё одного шрифта до неё снова сделала бы старт последовательным
+		bool	   logo_pending = !opt::NoLogo;
+		const auto printLogo	= [ & ] {
+			if ( !logo_pending ) return;
+			logo_pending = false;
+
+			using namespace srilakshmikanthanp;
+
+			libfiglet::figlet figlet_ProjectLogo( libfiglet::flf_font::make_shared( ( execdir / "Standard.flf" ).string( ) ),
+							      libfiglet::full_width::make_shared( ) );
+
+			llvm::outs( ) << "\n" << figlet_ProjectLogo( "cth++" ) << "\n";
+		};
+
+		if ( opt::Watch ) {
+			std::string project_dir = opt::WorkingDir, last_inputs;
+
+			// Конфиг и git-файлы, прочитанные целиком: если сохранение ничего не поменяло, перегенерация не нужна
+			const auto inputs = [ & ]( std::vector< std::string >& files ) {
+				files = gitWatchFiles( project_dir );
+				files.push_back( opt::ConfigFile );
+				if ( !opt::Schema.empty( ) ) files.push_back( opt::Schema );
+
+				std::string content;
+				for ( const auto& file : files ) content += readFile( file ).value_or( "" ) + '\0';
+				return content;
+			};
+
+			watch::run(
+					[ & ] {
+						const auto start = std::chrono::steady_clock::now( );
+
+						std::vector< std::string > files;
+						auto			   current = inputs( files );
+						if ( current == last_inputs ) return files;
+
+						try {
+							const auto config = readFile( opt::ConfigFile );
+							if ( !config ) throw std::runtime_error( "file not found: " + opt::ConfigFile );
+
+							if ( !opt::Schema.empty( ) ) {
+								const auto schema_text = readFile( opt::Schema );
+								if ( !schema_text ) throw std::runtime_error( "file not found: " + opt::Schema );
+								options.schema = *schema_text;
+							}
+
+							const auto result = cthpp::generate( options, *config );
+							printLogo( );
+
+							std::string summary;
+							for ( const auto& header : result.headers )
+								summary += ( summary.empty( ) ? "" : ", " ) + std::filesystem::path( header.path ).filename( ).string( )
+									   + ( writeIfChanged( header.path, header.content ) ? " updated" : " unchanged" );
+
+							if ( project_dir != result.project.project_dir ) {
+								project_dir = result.project.project_dir;
+								current	    = inputs( files );
+							}
+							last_inputs = std::move( current );
+
+							const auto elapsed = std::chrono::steady_clock::now( ) - start;
+							llvm::outs( ) << "[watch] " << summary << " in "
+								      << llvm::format( "%.2f", std::chrono::duration< double, std::milli >( elapsed ).count( ) ) << " ms\n";
+						} catch ( const std::exception& e ) {
+							llvm::errs( ) << "[watch] Error: " << e.what( ) << "\n";
+						}
+						llvm::outs( ).flush( );
+
+						return files;
+					},
+					std::chrono::milliseconds( opt::WatchDebounce ) );
+		}
 
-		os << "#define VERSION_PACK(MAJOR, MINOR, PATCH) ( ( ( MAJOR ) << 16 ) | ( ( MINOR ) << 8 ) | ( PATCH ) )"
-		   << "\n\n\n";
+		const auto result = cthpp::generate( options, *config );
+		printLogo( );
 
-		global_scope->print( os, policy );
+		for ( const auto& header : result.headers ) writeIfChanged( header.path, header.content );
 
 		if ( opt::RewriteConfig ) {
-			auto jp		    = json[ "project" ];
+			const auto& proj	= result.project;
+			auto	    config_json = json::parse( *config );
+
+			auto jp		    = config_json[ "project" ];
 			jp[ "working-dir" ] = proj.project_dir;
 			jp[ "output-path" ] = proj.output_path;
 			jp[ "debug" ]	    = proj.debug;
@@ -741,13 +462,11 @@ int main( int argc, char** argv )
 
 			std::ofstream of( opt::ConfigFile, std::ios::out | std::ios::binary | std::ios::trunc );
 			// of << json;
-			json.dump( of, true );
+			config_json.dump( of, true );
 			of.flush( );
 			of.close( );
 		}
 
-		delete ci;
-
 	} catch ( const std::exception& e ) {
 		llvm::errs( ) << "Error: " << e.what( ) << "\n";
 		llvm::errs( ) << "stack trace:\n";
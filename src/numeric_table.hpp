@@ -0,0 +1,264 @@
+// GPL3 lisence
+//
+// Created by @olokreaz on 19.10.2026.
+//
+
+#ifndef NUMERIC_TABLE_HPP
+#define NUMERIC_TABLE_HPP
+
+#include <llvm/Support/Format.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <jsoncons/json.hpp>
+
+// Быстрый путь для числовых массивов: значения берутся прямо из разобранного json (без конвертации через строку),
+// форматируются std::to_chars и пишутся в вывод крупными блоками, минуя clang AST.
+namespace numeric {
+
+	enum class Element : uint8_t
+	{
+		i64,
+		u64,
+		f64,
+	};
+
+	enum class FloatFormat : uint8_t
+	{
+		shortest,    // кратчайшая десятичная запись с round-trip
+		hex,	     // точный hex-float
+	};
+
+	struct Table
+	{
+		std::string		scope;	  // полное имя namespace, например config::server
+		std::string		name;
+		Element			element;
+		const jsoncons::json* values;
+	};
+
+	constexpr std::string_view spelling( const Element el )
+	{
+		switch ( el ) {
+			case Element::i64: return "long long";
+			case Element::u64: return "unsigned long long";
+			case Element::f64:
+			default		 : return "double";
+		}
+	}
+
+	constexpr std::string_view name( const FloatFormat fmt )
+	{
+		return fmt == FloatFormat::hex ? "hex" : "shortest";
+	}
+
+	// Тип элементов плоского непустого массива чисел; nullopt - массив идёт по общему пути
+	inline std::optional< Element > classify( const jsoncons::json& arr )
+	{
+		if ( !arr.is_array( ) || arr.empty( ) ) return std::nullopt;
+
+		bool has_signed = false, has_big_unsigned = false, has_float = false;
+
+		for ( const auto& v : arr.array_range( ) ) {
+			switch ( v.type( ) ) {
+				case jsoncons::json_type::int64_value : has_signed = true; break;
+				case jsoncons::json_type::uint64_value:
+					has_big_unsigned |= v.as< uint64_t >( ) > uint64_t( std::numeric_limits< int64_t >::max( ) );
+					break;
+				case jsoncons::json_type::double_value: has_float = true; break;
+				default				      : return std::nullopt;
+			}
+		}
+
+		if ( has_float ) return Element::f64;
+		if ( has_signed && has_big_unsigned ) return std::nullopt;
+		return has_signed ? Element::i64 : Element::u64;
+	}
+
+	// Кратчайший round-trip литерал double. to_chars выбирает фиксированную форму, когда она короче, и для целых значений
+	// она выходит без '.': 5.555555555555556e19 стал бы целым литералом больше ULLONG_MAX, а -0.0 - целым 0
+	inline char* writeShortest( char* first, char* last, const double v )
+	{
+		char* end = std::to_chars( first, last - 2, v ).ptr;    // место под ".0"
+		if ( std::find_if( first, end, []( const char c ) { return c == '.' || c == 'e' || c == 'p'; } ) == end ) {
+			*end++ = '.';
+			*end++ = '0';
+		}
+		return end;
+	}
+
+	class TableWriter
+	{
+		static constexpr size_t chunk_size    = 1 << 16;
+		static constexpr size_t max_literal   = 64;
+		static constexpr size_t max_separator = 4;    // ",\n\t\t"
+		static constexpr size_t per_line      = 8;
+
+		llvm::raw_ostream&		os_;
+		FloatFormat			fmt_;
+		std::array< char, chunk_size > buf_;
+		size_t				pos_   = 0;
+		size_t				count_ = 0;
+
+		void separator( )
+		{
+			if ( count_ ) buf_[ pos_++ ] = ',';
+			if ( count_ % per_line == 0 ) {
+				buf_[ pos_++ ] = '\n';
+				buf_[ pos_++ ] = '\t';
+				buf_[ pos_++ ] = '\t';
+			} else
+				buf_[ pos_++ ] = ' ';
+		}
+
+		char* begin( )
+		{
+			// Разделитель пишется до литерала, и после него в буфере всё ещё должно оставаться max_literal байт
+			if ( chunk_size - pos_ < max_separator + max_literal ) flush( );
+			separator( );
+			return buf_.data( ) + pos_;
+		}
+
+		void commit( const char* end )
+		{
+			pos_ = end - buf_.data( );
+			++count_;
+		}
+
+	public:
+		explicit TableWriter( llvm::raw_ostream& os, const FloatFormat fmt = FloatFormat::shortest ) : os_( os ), fmt_( fmt )
+		{
+		}
+
+		~TableWriter( )
+		{
+			flush( );
+		}
+
+		TableWriter( const TableWriter& )	     = delete;
+		TableWriter& operator=( const TableWriter& ) = delete;
+
+		[[nodiscard]] size_t count( ) const
+		{
+			return count_;
+		}
+
+		void flush( )
+		{
+			os_.write( buf_.data( ), pos_ );
+			pos_ = 0;
+		}
+
+		void write( const int64_t v )
+		{
+			char* p = begin( );
+			if ( v == std::numeric_limits< int64_t >::min( ) ) {
+				constexpr std::string_view min_literal = "(-9223372036854775807LL - 1)";
+				commit( std::copy( min_literal.begin( ), min_literal.end( ), p ) );
+				return;
+			}
+			commit( std::to_chars( p, p + max_literal, v ).ptr );
+		}
+
+		void write( const uint64_t v )
+		{
+			char* p	  = begin( );
+			char* end = std::to_chars( p, p + max_literal, v ).ptr;
+			if ( v > uint64_t( std::numeric_limits< int64_t >::max( ) ) ) *end++ = 'U';
+			commit( end );
+		}
+
+		void write( const double v )
+		{
+			if ( !std::isfinite( v ) ) throw std::logic_error( "[numeric] non-finite value in table" );
+
+			char* p = begin( );
+			if ( fmt_ == FloatFormat::shortest ) {
+				commit( writeShortest( p, p + max_literal, v ) );
+				return;
+			}
+
+			// to_chars( hex ) не пишет префикс 0x: -1.8p+1 -> -0x1.8p+1
+			char* digits = p;
+			if ( std::signbit( v ) ) *digits++ = '-';
+			digits[ 0 ] = '0';
+			digits[ 1 ] = 'x';
+			commit( std::to_chars( digits + 2, p + max_literal, std::fabs( v ), std::chars_format::hex ).ptr );
+		}
+	};
+
+	// namespace <scope> { constexpr <type> <name>[] = { ... }; }
+	inline size_t emitTable( llvm::raw_ostream& os, const Table& table, const FloatFormat fmt )
+	{
+		os << "namespace " << table.scope << " {\n\tconstexpr " << spelling( table.element ) << " " << table.name << "[] = {";
+
+		size_t count;
+		{
+			TableWriter writer( os, fmt );
+			switch ( table.element ) {
+				case Element::i64:
+					for ( const auto& v : table.values->array_range( ) ) writer.write( v.as< int64_t >( ) );
+					break;
+				case Element::u64:
+					for ( const auto& v : table.values->array_range( ) ) writer.write( v.as< uint64_t >( ) );
+					break;
+				case Element::f64:
+					for ( const auto& v : table.values->array_range( ) ) writer.write( v.as< double >( ) );
+					break;
+			}
+			count = writer.count( );
+		}
+
+		os << "\n\t};\n}\n\n";
+		return count;
+	}
+
+	// Скорость вывода на синтетических таблицах из `count` элементов, в элементах в секунду
+	inline void benchmark( llvm::raw_ostream& log, const size_t count, const FloatFormat fmt )
+	{
+		std::mt19937_64			  rng( 0x637468 );
+		std::uniform_real_distribution< double > real( -1e6, 1e6 );
+
+		jsoncons::json f64_values( jsoncons::json_array_arg ), i64_values( jsoncons::json_array_arg ),
+				u64_values( jsoncons::json_array_arg );
+		f64_values.reserve( count );
+		i64_values.reserve( count );
+		u64_values.reserve( count );
+
+		for ( size_t i = 0; i < count; ++i ) {
+			f64_values.push_back( real( rng ) );
+			i64_values.push_back( static_cast< int64_t >( rng( ) ) );
+			u64_values.push_back( static_cast< uint64_t >( rng( ) ) );
+		}
+
+		const auto run = [ & ]( const Element el, const jsoncons::json& values ) {
+			llvm::raw_null_ostream sink;
+
+			const auto start   = std::chrono::steady_clock::now( );
+			const auto emitted = emitTable( sink, { "bench", "table", el, &values }, fmt );
+			const auto elapsed = std::chrono::duration< double >( std::chrono::steady_clock::now( ) - start ).count( );
+
+			log << "[bench] " << spelling( el ) << ( el == Element::f64 ? " (" + std::string( name( fmt ) ) + ")" : "" ) << ": "
+			    << emitted << " elements in " << llvm::format( "%.3f", elapsed * 1e3 ) << " ms, "
+			    << llvm::format( "%.2f", emitted / elapsed / 1e6 ) << " M elements/s\n";
+		};
+
+		run( Element::f64, f64_values );
+		run( Element::i64, i64_values );
+		run( Element::u64, u64_values );
+	}
+}    // namespace numeric
+
+#endif	  //NUMERIC_TABLE_HPP
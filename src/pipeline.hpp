@@ -0,0 +1,146 @@
+// GPL3 lisence
+//
+// Created by @olokreaz on 19.10.2026.
+//
+
+#ifndef PIPELINE_HPP
+#define PIPELINE_HPP
+
+#include <llvm/Support/Format.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Небольшой граф задач для старта: независимые фазы выполняются параллельно, зависимости задаются явно
+namespace pipeline {
+
+	class TaskGraph
+	{
+	public:
+		using Id    = size_t;
+		using Clock = std::chrono::steady_clock;
+
+	private:
+		struct Task
+		{
+			std::string		name;
+			std::function< void( ) > fn;
+			std::vector< Id >	deps;
+
+			Clock::time_point  begin, end;
+			std::exception_ptr error;
+			bool		   skipped{ false };    // не запускалась: упала одна из зависимостей
+		};
+
+		std::vector< Task > tasks_;
+		Clock::time_point   start_, finish_;
+
+		static std::string what( const std::exception_ptr& error )
+		{
+			try {
+				std::rethrow_exception( error );
+			} catch ( const std::exception& e ) {
+				return e.what( );
+			} catch ( ... ) {
+				return "Unknown error";
+			}
+		}
+
+		static bool execute( Task& task )
+		{
+			task.begin = Clock::now( );
+			try {
+				task.fn( );
+			} catch ( ... ) {
+				task.error = std::current_exception( );
+			}
+			task.end = Clock::now( );
+
+			return !task.error;
+		}
+
+		static bool skip( Task& task )
+		{
+			task.skipped = true;
+			return false;
+		}
+
+	public:
+		// Зависимости должны быть добавлены раньше, поэтому граф всегда ациклический
+		Id add( std::string name, std::function< void( ) > fn, std::vector< Id > deps = { } )
+		{
+			for ( [[maybe_unused]] const Id dep : deps ) assert( dep < tasks_.size( ) && "[pipeline] dependency must be added first" );
+
+			tasks_.push_back( { std::move( name ), std::move( fn ), std::move( deps ) } );
+			return tasks_.size( ) - 1;
+		}
+
+		// Ждёт все задачи; ошибки всех упавших фаз собираются в одно исключение. concurrent = false выполняет фазы по
+		// порядку добавления в вызывающем потоке: это уже топологический порядок, а потоки на каждый вызов не создаются
+		void run( const bool concurrent = true )
+		{
+			start_ = Clock::now( );
+
+			if ( concurrent ) {
+				std::vector< std::shared_future< bool > > done( tasks_.size( ) );
+
+				for ( Id id = 0; id < tasks_.size( ); ++id )
+					done[ id ] = std::async( std::launch::async,
+								 [ this, id, &done ] {
+									 for ( const Id dep : tasks_[ id ].deps )
+										 if ( !done[ dep ].get( ) ) return skip( tasks_[ id ] );
+									 return execute( tasks_[ id ] );
+								 } )
+							     .share( );
+
+				for ( const auto& f : done ) f.wait( );
+			} else {
+				std::vector< char > ok( tasks_.size( ) );
+
+				for ( Id id = 0; id < tasks_.size( ); ++id )
+					ok[ id ] = std::all_of( tasks_[ id ].deps.begin( ), tasks_[ id ].deps.end( ), [ & ]( const Id dep ) { return ok[ dep ]; } )
+							   ? execute( tasks_[ id ] )
+							   : skip( tasks_[ id ] );
+			}
+
+			finish_ = Clock::now( );
+
+			std::string errors;
+			for ( const auto& task : tasks_ )
+				if ( task.error ) errors += ( errors.empty( ) ? "" : "\n" ) + ( "[" + task.name + "] " + what( task.error ) );
+
+			if ( !errors.empty( ) ) throw std::runtime_error( errors );
+		}
+
+		// Начало и конец каждой фазы относительно старта графа, плюс суммарное время против wall time
+		void printTimings( llvm::raw_ostream& os ) const
+		{
+			const auto ms = [ this ]( const Clock::time_point tp ) {
+				return std::chrono::duration< double, std::milli >( tp - start_ ).count( );
+			};
+
+			double sum = 0;
+			for ( const auto& task : tasks_ ) {
+				if ( task.skipped ) {
+					os << llvm::format( "[startup] %-10s skipped\n", task.name.c_str( ) );
+					continue;
+				}
+				sum += ms( task.end ) - ms( task.begin );
+				os << llvm::format( "[startup] %-10s %8.2f .. %8.2f ms\n", task.name.c_str( ), ms( task.begin ), ms( task.end ) );
+			}
+
+			const double wall = ms( finish_ );
+			os << llvm::format( "[startup] wall %.2f ms, phases sum %.2f ms, overlap x%.2f\n", wall, sum, wall > 0 ? sum / wall : 1.0 );
+		}
+	};
+}    // namespace pipeline
+
+#endif	  //PIPELINE_HPP
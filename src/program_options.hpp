@@ -8,6 +8,8 @@
 
 #include <llvm/Support/CommandLine.h>
 
+#include "./numeric_table.hpp"
+
 namespace cl = llvm::cl;
 
 namespace opt {
@@ -16,7 +18,6 @@ namespace opt {
 	static cl::opt< std::string > ConfigFile( "config",
 						  cl::desc( "Path to the JSON configuration file" ),
 						  cl::value_desc( "path" ),
-						  cl::Required,
 						  cl::cat( CthOption ) );
 
 	static cl::opt< std::string >
@@ -67,8 +68,59 @@ namespace opt {
 
 	static cl::opt< bool > NoLogo( "no-logo", cl::desc( "Disable logo" ), cl::init( false ), cl::cat( CthOption ) );
 
+	static cl::opt< bool > Watch( "watch",
+				      cl::desc( "Keep running and regenerate when the config or git HEAD changes" ),
+				      cl::init( false ),
+				      cl::cat( CthOption ) );
+
+	static cl::opt< unsigned > WatchDebounce( "watch-debounce",
+						  cl::desc( "Quiet period after the last change before --watch regenerates" ),
+						  cl::value_desc( "ms" ),
+						  cl::init( 10 ),
+						  cl::cat( CthOption ) );
+
+	static cl::opt< bool > Timings( "timings", cl::desc( "Print per-phase startup timings" ), cl::init( false ), cl::cat( CthOption ) );
+
 	static cl::opt< bool > NoGit( "no-git", cl::desc( "Disable git hash" ), cl::init( false ), cl::cat( CthOption ) );
 
+	static cl::opt< bool > Stable( "stable",
+				       cl::desc( "Deterministic header for compiler caches: git hash and target go to a separate build info header" ),
+				       cl::init( false ),
+				       cl::cat( CthOption ) );
+
+	static cl::opt< std::string > BuildInfoPath( "build-info",
+						     cl::desc( "Build info header path for --stable (default: <output dir>/conf_build_info.hpp)" ),
+						     cl::value_desc( "path" ),
+						     cl::cat( CthOption ) );
+
+	static cl::opt< std::string > PruneUsing( "prune-using",
+						  cl::desc( "Emit only the keys referenced by the target sources listed in compile_commands.json" ),
+						  cl::value_desc( "compile_commands.json" ),
+						  cl::cat( CthOption ) );
+
+	static cl::opt< bool > Reflection( "reflection",
+					   cl::desc( "Emit constexpr reflection metadata (<namespace>::_meta::fields, for_each)" ),
+					   cl::init( false ),
+					   cl::cat( CthOption ) );
+
+	static cl::opt< std::string > Schema( "schema",
+					      cl::desc( "Validate the config against a JSON Schema and emit static_asserts for its numeric and length bounds" ),
+					      cl::value_desc( "path" ),
+					      cl::cat( CthOption ) );
+
+	static cl::opt< numeric::FloatFormat > FloatFormat( "float-format",
+							    cl::desc( "Literal format of floating-point numeric tables" ),
+							    cl::values( clEnumValN( numeric::FloatFormat::shortest, "shortest", "Shortest round-trip decimal" ),
+									clEnumValN( numeric::FloatFormat::hex, "hex", "Exact hex-float" ) ),
+							    cl::init( numeric::FloatFormat::shortest ),
+							    cl::cat( CthOption ) );
+
+	static cl::opt< unsigned > BenchNumeric( "bench-numeric",
+						 cl::desc( "Measure numeric table emission throughput on <count> elements and exit" ),
+						 cl::value_desc( "count" ),
+						 cl::init( 0 ),
+						 cl::cat( CthOption ) );
+
 	static cl::opt< bool > CreateConfig( "create", cl::desc( "Create a new configuration file" ), cl::init( false ) );
 	static cl::opt< bool > WithCmake( "cmake", cl::desc( "Include CMake target in the configuration file" ), cl::init( false ) );
 }    // namespace opt
@@ -0,0 +1,116 @@
+// GPL3 lisence
+//
+// Created by @olokreaz on 19.10.2026.
+//
+
+#ifndef REFLECTION_HPP
+#define REFLECTION_HPP
+
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// --reflection: constexpr-метаданные по каждому ключу, <ns>::_meta::fields - std::tuple из field{ path, tag, array, &value }
+// в порядке parseJsonObject( ), и _meta::for_each, который разворачивается на этапе компиляции
+namespace reflection {
+
+	struct Entry
+	{
+		std::string scope;    // полное имя namespace, например config::server
+		std::string name;
+		std::string tag;      // имя TypeBuilder::Types: boolean, u32, i64, f64, string...
+		bool	    array{ false };
+	};
+
+	namespace detail {
+		inline size_t depth( const std::string_view scope )
+		{
+			size_t n = 0;
+			for ( auto pos = scope.find( "::" ); pos != std::string_view::npos; pos = scope.find( "::", pos + 2 ) ) ++n;
+			return n;
+		}
+
+		struct Segment
+		{
+			const Entry* leaf{ nullptr };
+			std::string  child;
+		};
+	}    // namespace detail
+
+	inline void emit( llvm::raw_ostream& os, const std::string& root, const std::vector< Entry >& entries )
+	{
+		// Для каждого namespace - его элементы по порядку: собственные ключи и вложенные namespace целиком
+		std::map< std::string, std::vector< detail::Segment > > scopes{ { root, { } } };
+
+		for ( const auto& entry : entries ) {
+			std::string scope = root;
+			while ( scope != entry.scope ) {
+				const auto next	 = entry.scope.find( "::", scope.size( ) + 2 );
+				auto	   child = entry.scope.substr( 0, next );
+
+				auto& segments = scopes[ scope ];
+				if ( segments.empty( ) || segments.back( ).child != child ) segments.push_back( { nullptr, child } );
+
+				scope = std::move( child );
+			}
+			scopes[ scope ].push_back( { &entry, { } } );
+		}
+
+		const std::string meta = "::" + root + "::_meta";
+
+		os << "namespace " << root << "::_meta {\n"
+		   << "\tenum class type : unsigned char { boolean, i8, u8, i16, u16, i32, u32, i64, u64, f32, f64, string };\n\n"
+		   << "\ttemplate< class T >\n"
+		   << "\tstruct field\n"
+		   << "\t{\n"
+		   << "\t\tconst char* path;\n"
+		   << "\t\ttype\t    tag;\n"
+		   << "\t\tbool\t    array;\n"
+		   << "\t\tconst T*    value;\n"
+		   << "\t};\n\n"
+		   << "\ttemplate< class Fields, class F >\n"
+		   << "\tconstexpr void for_each( const Fields& fields, F&& f )\n"
+		   << "\t{\n"
+		   << "\t\tstd::apply( [ & ]( const auto&... fs ) { ( f( fs ), ... ); }, fields );\n"
+		   << "\t}\n"
+		   << "}\n\n";
+
+		// Вложенные namespace раньше родителей: родитель ссылается на их fields
+		std::vector< const std::string* > order;
+		for ( const auto& [ scope, segments ] : scopes ) order.push_back( &scope );
+		std::stable_sort( order.begin( ), order.end( ), []( const std::string* a, const std::string* b ) {
+			return detail::depth( *a ) > detail::depth( *b );
+		} );
+
+		for ( const auto* scope : order ) {
+			const auto& segments = scopes[ *scope ];
+
+			os << "namespace " << *scope << "::_meta {\n\tconstexpr auto fields = std::tuple_cat(";
+			for ( size_t i = 0; i < segments.size( ); ++i ) {
+				os << ( i ? ",\n\t\t" : "\n\t\t" );
+				if ( const auto* leaf = segments[ i ].leaf ) {
+					const auto path = leaf->scope + "::" + leaf->name;
+					os << "std::make_tuple( " << meta << "::field< decltype( ::" << path << " ) >{ \"" << path << "\", " << meta
+					   << "::type::" << leaf->tag << ", " << ( leaf->array ? "true" : "false" ) << ", &::" << path << " } )";
+				} else
+					os << "::" << segments[ i ].child << "::_meta::fields";
+			}
+			os << " );\n";
+
+			if ( *scope == root )
+				os << "\n\ttemplate< class F >\n"
+				   << "\tconstexpr void for_each( F&& f )\n"
+				   << "\t{\n"
+				   << "\t\tfor_each( fields, f );\n"
+				   << "\t}\n";
+
+			os << "}\n\n";
+		}
+	}
+}    // namespace reflection
+
+#endif	  //REFLECTION_HPP
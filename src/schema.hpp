@@ -0,0 +1,300 @@
+// GPL3 lisence
+//
+// Created by @olokreaz on 19.10.2026.
+//
+
+#ifndef SCHEMA_HPP
+#define SCHEMA_HPP
+
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/jsonschema/jsonschema.hpp>
+
+#include "./numeric_table.hpp"
+
+// --schema: проверка конфига по JSON Schema при генерации и static_assert'ы с теми же ограничениями в заголовке
+namespace schema {
+
+	// Ограничения одного ключа; для числовых таблиц - ограничения items, проверяемые для каждого элемента
+	struct Constraint
+	{
+		std::string path;    // config::server::port
+		bool	    array{ false };
+		bool	    is_unsigned{ false };
+		bool	    is_integer{ false };
+		bool	    is_string{ false };
+
+		std::optional< jsoncons::json > minimum, maximum, exclusive_minimum, exclusive_maximum, multiple_of;
+		std::optional< uint64_t >	  min_length, max_length;
+		bool				  power_of_two{ false };    // "x-power-of-two": true, расширение cth++
+	};
+
+	namespace detail {
+		template< class Location >
+		std::string location( const Location& loc )
+		{
+			if constexpr ( std::is_convertible_v< Location, std::string > )
+				return loc;
+			else
+				return loc.string( );
+		}
+
+		// Знаковый литерал, пока помещается в int64: иначе отрицательное значение сравнивалось бы как беззнаковое
+		inline std::string literal( const jsoncons::json& v )
+		{
+			if ( v.is_int64( ) ) return std::to_string( v.as< int64_t >( ) ) + "LL";
+			if ( v.is_uint64( ) ) {
+				const auto u = v.as< uint64_t >( );
+				return std::to_string( u ) + ( u > static_cast< uint64_t >( INT64_MAX ) ? "ULL" : "LL" );
+			}
+
+			char buf[ 64 ];
+			return std::string( buf, numeric::writeShortest( buf, buf + sizeof( buf ), v.as< double >( ) ) );
+		}
+
+		inline bool negative( const jsoncons::json& v )
+		{
+			return v.is_int64( ) ? v.as< int64_t >( ) < 0 : v.is_double( ) && v.as< double >( ) < 0;
+		}
+
+		inline void read( const jsoncons::json& s, Constraint& c )
+		{
+			const auto get = [ & ]( const char* name, std::optional< jsoncons::json >& out ) {
+				if ( s.contains( name ) && s[ name ].is_number( ) ) out = s[ name ];
+			};
+			get( "minimum", c.minimum );
+			get( "maximum", c.maximum );
+			get( "exclusiveMinimum", c.exclusive_minimum );
+			get( "exclusiveMaximum", c.exclusive_maximum );
+			get( "multipleOf", c.multiple_of );
+
+			if ( s.contains( "minLength" ) ) c.min_length = s[ "minLength" ].as< uint64_t >( );
+			if ( s.contains( "maxLength" ) ) c.max_length = s[ "maxLength" ].as< uint64_t >( );
+			if ( s.contains( "x-power-of-two" ) ) c.power_of_two = s[ "x-power-of-two" ].as< bool >( );
+		}
+
+		inline bool empty( const Constraint& c )
+		{
+			return !c.minimum && !c.maximum && !c.exclusive_minimum && !c.exclusive_maximum && !c.multiple_of && !c.min_length
+			       && !c.max_length && !c.power_of_two;
+		}
+	}    // namespace detail
+
+	// Все нарушения схемы разом, с путём до значения
+	inline void validate( const jsoncons::json& schema, const jsoncons::json& config )
+	{
+		auto compiled = jsoncons::jsonschema::make_json_schema( schema );
+
+		std::string errors;
+		compiled.validate( config, [ & ]( const jsoncons::jsonschema::validation_message& msg ) {
+			errors += "\n\t" + detail::location( msg.instance_location( ) ) + ": " + msg.message( );
+			return jsoncons::jsonschema::walk_result::advance;
+		} );
+
+		if ( !errors.empty( ) ) throw std::runtime_error( "[schema] config does not match the schema:" + errors );
+	}
+
+	namespace detail {
+		// Локальный $ref ( "#/definitions/port", "#/$defs/port" ) от корня схемы; внешние ссылки не разрешаются
+		inline const jsoncons::json* follow( const jsoncons::json& root, const std::string& ref )
+		{
+			if ( ref == "#" ) return &root;
+			if ( ref.rfind( "#/", 0 ) != 0 ) return nullptr;
+
+			const jsoncons::json* node = &root;
+			for ( size_t pos = 2;; ) {
+				const auto end	 = ref.find( '/', pos );
+				auto	   token = ref.substr( pos, end == std::string::npos ? std::string::npos : end - pos );
+				for ( size_t i = token.find( '~' ); i != std::string::npos && i + 1 < token.size( ); i = token.find( '~', i + 1 ) )
+					token.replace( i, 2, token[ i + 1 ] == '1' ? "/" : "~" );
+
+				if ( node->is_object( ) && node->contains( token ) )
+					node = &node->at( token );
+				else if ( node->is_array( ) && !token.empty( ) && token.find_first_not_of( "0123456789" ) == std::string::npos
+					  && std::stoull( token ) < node->size( ) )
+					node = &node->at( std::stoull( token ) );
+				else
+					return nullptr;
+
+				if ( end == std::string::npos ) return node;
+				pos = end + 1;
+			}
+		}
+
+		// Схема вместе с её $ref и allOf. Ключевые слова, ограничения из которых в static_assert не попадают ( anyOf, oneOf,
+		// if, not, внешние $ref ), складываются в skipped: валидатор их всё равно проверяет
+		inline void flatten( const jsoncons::json&		    root,
+				     const jsoncons::json&		    s,
+				     std::vector< const jsoncons::json* >& out,
+				     std::set< std::string >&		    skipped,
+				     const int				    depth = 0 )
+		{
+			if ( !s.is_object( ) ) return;
+			if ( depth > 32 ) {
+				skipped.insert( "$ref cycle" );
+				return;
+			}
+
+			if ( s.contains( "$ref" ) ) {
+				const auto ref = s.at( "$ref" ).as< std::string >( );
+				if ( const auto* target = follow( root, ref ) )
+					flatten( root, *target, out, skipped, depth + 1 );
+				else
+					skipped.insert( "$ref " + ref );
+			}
+
+			out.push_back( &s );
+
+			if ( s.contains( "allOf" ) )
+				for ( const auto& sub : s.at( "allOf" ).array_range( ) ) flatten( root, sub, out, skipped, depth + 1 );
+
+			for ( const char* keyword : { "anyOf", "oneOf", "if", "not" } )
+				if ( s.contains( keyword ) ) skipped.insert( keyword );
+		}
+
+		inline void collect( const jsoncons::json&			 root,
+				     const std::vector< const jsoncons::json* >& schemas,
+				     const jsoncons::json&			 value,
+				     const std::string&				 scope,
+				     std::vector< Constraint >&			 out,
+				     std::vector< std::string >&		 skipped )
+		{
+			if ( !value.is_object( ) ) return;
+
+			for ( const auto& item : value.object_range( ) ) {
+				const auto  key	  = std::string( item.key( ) );
+				const auto& val	  = item.value( );
+				const auto  table = numeric::classify( val );
+
+				std::vector< const jsoncons::json* > subs;
+				std::set< std::string >		     unsupported;
+				for ( const auto* parent : schemas )
+					if ( parent->contains( "properties" ) && parent->at( "properties" ).contains( key ) )
+						flatten( root, parent->at( "properties" ).at( key ), subs, unsupported );
+
+				if ( val.is_object( ) || ( val.is_array( ) && !table ) ) {
+					for ( const auto& keyword : unsupported ) skipped.push_back( scope + "::" + key + ": " + keyword );
+					collect( root, subs, val, scope + "::" + key, out, skipped );
+					continue;
+				}
+
+				auto name = key;
+				for ( auto pos = name.find( '-' ); pos != std::string::npos; pos = name.find( '-' ) ) name[ pos ] = '_';
+
+				// Ограничения каждой подсхемы - отдельный static_assert: выполняться должны все
+				std::vector< const jsoncons::json* > items;
+				if ( table )
+					for ( const auto* sub : subs )
+						if ( sub->contains( "items" ) ) flatten( root, sub->at( "items" ), items, unsupported );
+
+				for ( const auto& keyword : unsupported ) skipped.push_back( scope + "::" + name + ": " + keyword );
+
+				if ( !table && !val.is_number( ) && !val.is_string( ) ) continue;
+
+				for ( const auto* sub : table ? items : subs ) {
+					Constraint c;
+					c.path = scope + "::" + name;
+					if ( table ) {
+						c.array	      = true;
+						c.is_unsigned = *table == numeric::Element::u64;
+						c.is_integer  = *table != numeric::Element::f64;
+					} else {
+						c.is_unsigned = val.is_uint64( );
+						c.is_integer  = val.is_int64( ) || val.is_uint64( );
+						c.is_string   = val.is_string( );
+					}
+					read( *sub, c );
+
+					if ( !empty( c ) ) out.push_back( std::move( c ) );
+				}
+			}
+		}
+	}    // namespace detail
+
+	// Обходит схему всего документа параллельно с config, повторяя именование parseJsonObject( ). properties следуют через
+	// локальные $ref и allOf; ключи, часть ограничений которых в static_assert не попала, возвращаются в skipped
+	inline void collect( const jsoncons::json&	 root,
+			     const jsoncons::json&	 config,
+			     const std::string&		 scope,
+			     std::vector< Constraint >&	 out,
+			     std::vector< std::string >& skipped )
+	{
+		std::vector< const jsoncons::json* > top, schemas;
+		std::set< std::string >		     unsupported;
+		detail::flatten( root, root, top, unsupported );
+
+		for ( const auto* s : top )
+			if ( s->contains( "properties" ) && s->at( "properties" ).contains( "config" ) )
+				detail::flatten( root, s->at( "properties" ).at( "config" ), schemas, unsupported );
+
+		for ( const auto& keyword : unsupported ) skipped.push_back( scope + ": " + keyword );
+
+		detail::collect( root, schemas, config, scope, out, skipped );
+	}
+
+	// static_assert на каждый ключ; у беззнаковых значений отрицательные нижние границы выполняются всегда и опускаются.
+	// minLength/maxLength в JSON Schema считают code points, а не байты UTF-8, поэтому длина считается <root>::_schema::length
+	inline void emit( llvm::raw_ostream& os, const std::string& root, const std::vector< Constraint >& constraints )
+	{
+		if ( std::any_of( constraints.begin( ), constraints.end( ), []( const Constraint& c ) {
+			     return c.is_string && ( c.min_length || c.max_length );
+		     } ) )
+			os << "namespace " << root << "::_schema {\n"
+			   << "\tconstexpr unsigned long long length( const char* s )\n"
+			   << "\t{\n"
+			   << "\t\tunsigned long long n = 0;\n"
+			   << "\t\tfor ( ; *s; ++s ) n += ( static_cast< unsigned char >( *s ) & 0xC0 ) != 0x80;\n"
+			   << "\t\treturn n;\n"
+			   << "\t}\n"
+			   << "}\n\n";
+
+		const std::string length = "::" + root + "::_schema::length( ";
+
+		for ( const auto& c : constraints ) {
+			const std::string v = c.array ? "v" : "::" + c.path;
+
+			std::vector< std::string > clauses;
+			const auto		   bound = [ & ]( const std::optional< jsoncons::json >& b, const char* op, const bool lower ) {
+				  if ( !b || ( lower && c.is_unsigned && detail::negative( *b ) ) ) return;
+				  clauses.push_back( v + " " + op + " " + detail::literal( *b ) );
+			};
+
+			if ( c.is_string ) {
+				if ( c.min_length ) clauses.push_back( length + v + " ) >= " + std::to_string( *c.min_length ) );
+				if ( c.max_length ) clauses.push_back( length + v + " ) <= " + std::to_string( *c.max_length ) );
+			} else {
+				bound( c.minimum, ">=", true );
+				bound( c.exclusive_minimum, ">", true );
+				bound( c.maximum, "<=", false );
+				bound( c.exclusive_maximum, "<", false );
+
+				if ( c.is_integer && c.multiple_of && ( c.multiple_of->is_int64( ) || c.multiple_of->is_uint64( ) ) )
+					clauses.push_back( v + " % " + detail::literal( *c.multiple_of ) + " == 0" );
+				if ( c.is_integer && c.power_of_two ) clauses.push_back( v + " > 0 && ( " + v + " & ( " + v + " - 1 ) ) == 0" );
+			}
+
+			if ( clauses.empty( ) ) continue;
+
+			std::string cond;
+			for ( const auto& clause : clauses ) cond += ( cond.empty( ) ? "" : " && " ) + ( "( " + clause + " )" );
+
+			if ( c.array )
+				os << "static_assert( [] {\n\tfor ( const auto v : ::" << c.path << " )\n\t\tif ( !( " << cond
+				   << " ) ) return false;\n\treturn true;\n}( ), \"" << c.path << ": item out of schema range\" );\n";
+			else
+				os << "static_assert( " << cond << ", \"" << c.path << ": out of schema range\" );\n";
+		}
+	}
+}    // namespace schema
+
+#endif	  //SCHEMA_HPP
@@ -0,0 +1,304 @@
+// GPL3 lisence
+//
+// Created by @olokreaz on 19.10.2026.
+//
+
+#ifndef USAGE_SCAN_HPP
+#define USAGE_SCAN_HPP
+
+#include <clang/AST/Decl.h>
+#include <clang/ASTMatchers/ASTMatchFinder.h>
+#include <clang/ASTMatchers/ASTMatchers.h>
+#include <clang/Basic/Diagnostic.h>
+#include <clang/Frontend/CompilerInstance.h>
+#include <clang/Frontend/FrontendAction.h>
+#include <clang/Frontend/Utils.h>
+#include <clang/Tooling/JSONCompilationDatabase.h>
+#include <clang/Tooling/Tooling.h>
+
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/xxhash.h>
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <jsoncons/json.hpp>
+
+// --prune-using: какие ключи конфига реально используются исходниками таргета
+namespace usage {
+
+	struct VirtualFile
+	{
+		std::string path;
+		std::string content;
+	};
+
+	class RefCollector : public clang::ast_matchers::MatchFinder::MatchCallback
+	{
+		std::string		prefix_;
+		std::set< std::string >& refs_;
+
+	public:
+		RefCollector( std::string prefix, std::set< std::string >& refs ) : prefix_( std::move( prefix ) ), refs_( refs )
+		{
+		}
+
+		void run( const clang::ast_matchers::MatchFinder::MatchResult& result ) override
+		{
+			const auto* var = result.Nodes.getNodeAs< clang::VarDecl >( "var" );
+			if ( !var ) return;
+
+			auto name = var->getQualifiedNameAsString( );
+			if ( llvm::StringRef( name ).starts_with( prefix_ ) ) refs_.insert( std::move( name ) );
+		}
+	};
+
+	// Разбор одного исходника: матчеры плюс список подключённых несистемных файлов, от которых зависят найденные ссылки.
+	// Ошибки компиляции берутся из DiagnosticsEngine: IgnoringDiagConsumer их не считает, и ClangTool::run( ) возвращает 0
+	class ScanAction : public clang::ASTFrontendAction
+	{
+		clang::ast_matchers::MatchFinder&	     finder_;
+		std::vector< std::string >&		     deps_;
+		bool&					     failed_;
+		std::shared_ptr< clang::DependencyCollector > collector_ = std::make_shared< clang::DependencyCollector >( );
+
+	public:
+		ScanAction( clang::ast_matchers::MatchFinder& finder, std::vector< std::string >& deps, bool& failed )
+			: finder_( finder ), deps_( deps ), failed_( failed )
+		{
+		}
+
+	protected:
+		std::unique_ptr< clang::ASTConsumer > CreateASTConsumer( clang::CompilerInstance&, llvm::StringRef ) override
+		{
+			return finder_.newASTConsumer( );
+		}
+
+		// Препроцессор уже создан, но главный файл в него ещё не вошёл
+		bool BeginSourceFileAction( clang::CompilerInstance& ci ) override
+		{
+			collector_->attachToPreprocessor( ci.getPreprocessor( ) );
+			return true;
+		}
+
+		void EndSourceFileAction( ) override
+		{
+			failed_ |= getCompilerInstance( ).getDiagnostics( ).hasErrorOccurred( );
+
+			const auto deps = collector_->getDependencies( );
+			deps_.assign( deps.begin( ), deps.end( ) );
+		}
+	};
+
+	class ScanActionFactory : public clang::tooling::FrontendActionFactory
+	{
+		clang::ast_matchers::MatchFinder& finder_;
+		std::vector< std::string >&	  deps_;
+		bool&				  failed_;
+
+	public:
+		ScanActionFactory( clang::ast_matchers::MatchFinder& finder, std::vector< std::string >& deps, bool& failed )
+			: finder_( finder ), deps_( deps ), failed_( failed )
+		{
+		}
+
+		std::unique_ptr< clang::FrontendAction > create( ) override
+		{
+			return std::make_unique< ScanAction >( finder_, deps_, failed_ );
+		}
+	};
+
+	inline std::string absolutePath( const llvm::StringRef dir, const llvm::StringRef path )
+	{
+		llvm::SmallString< 256 > abs( path );
+		llvm::sys::fs::make_absolute( dir, abs );
+		llvm::sys::path::remove_dots( abs, true );
+		return std::string( abs );
+	}
+
+	// Хеш содержимого файла, пустая строка - файл не читается
+	inline std::string contentHash( const std::string& path )
+	{
+		auto buffer = llvm::MemoryBuffer::getFile( path, false, false );
+		return buffer ? llvm::utohexstr( llvm::xxHash64( ( *buffer )->getBuffer( ) ) ) : std::string( );
+	}
+
+	// Хеш исходника, его командной строки и полного (непрунингованного) заголовка. Подключаемые файлы проверяются отдельно,
+	// по хешам из записи кеша: их список известен только после разбора
+	inline std::string fileKey( const clang::tooling::CompileCommand& cmd, const std::vector< VirtualFile >& headers )
+	{
+		auto buffer = llvm::MemoryBuffer::getFile( absolutePath( cmd.Directory, cmd.Filename ), false, false );
+		if ( !buffer ) throw std::runtime_error( "[prune] cannot read " + cmd.Filename + ": " + buffer.getError( ).message( ) );
+
+		uint64_t hash = llvm::xxHash64( ( *buffer )->getBuffer( ) );
+		for ( const auto& arg : cmd.CommandLine ) hash ^= llvm::xxHash64( arg ) + 0x9e3779b97f4a7c15ULL + ( hash << 6 ) + ( hash >> 2 );
+		for ( const auto& vf : headers ) hash ^= llvm::xxHash64( vf.content ) + 0x9e3779b97f4a7c15ULL + ( hash << 6 ) + ( hash >> 2 );
+
+		return llvm::utohexstr( hash );
+	}
+
+	// Ссылки из кеша, если совпали ключ файла и хеши всех его зависимостей; битая запись считается промахом
+	inline std::optional< std::vector< std::string > > cachedRefs( const jsoncons::json& cache,
+								       const std::string&    file,
+								       const std::string&    key,
+								       llvm::raw_ostream&    log )
+	{
+		if ( !cache.contains( file ) ) return std::nullopt;
+
+		try {
+			const auto& entry = cache[ file ];
+			if ( entry[ "hash" ].as< std::string >( ) != key ) return std::nullopt;
+
+			for ( const auto& dep : entry[ "deps" ].object_range( ) )
+				if ( contentHash( std::string( dep.key( ) ) ) != dep.value( ).as< std::string >( ) ) return std::nullopt;
+
+			std::vector< std::string > refs;
+			for ( const auto& ref : entry[ "refs" ].array_range( ) ) refs.push_back( ref.as< std::string >( ) );
+			return refs;
+		} catch ( const std::exception& ) {
+			log << "[prune] ignoring broken cache entry for " << file << "\n";
+			return std::nullopt;
+		}
+	}
+
+	// Исходники таргета: те, в чьей командной строке есть каталог сгенерированного заголовка (add_target_config добавляет его в
+	// include directories). Если таких нет - все файлы базы.
+	inline std::vector< clang::tooling::CompileCommand > targetCommands( const clang::tooling::CompilationDatabase& db,
+									      const llvm::StringRef		      header_dir )
+	{
+		std::vector< clang::tooling::CompileCommand > all = db.getAllCompileCommands( ), target;
+
+		for ( const auto& cmd : all )
+			if ( std::any_of( cmd.CommandLine.begin( ), cmd.CommandLine.end( ), [ & ]( const std::string& arg ) {
+				     return llvm::StringRef( arg ).contains( header_dir );
+			     } ) )
+				target.push_back( cmd );
+
+		return target.empty( ) ? all : target;
+	}
+
+	// Полные имена ( <namespace>::...::key ) всех переменных конфига, на которые ссылаются исходники из compile_commands.json.
+	// Результат по каждому файлу кешируется в cache_path по хешу файла и всех подключённых им несистемных заголовков.
+	// nullopt, если хотя бы один файл не скомпилировался: его ссылки неполны, и урезать заголовок нельзя
+	inline std::optional< std::set< std::string > > scan( const std::string&		     compile_commands,
+					     const std::string&		     header_dir,
+					     const std::vector< VirtualFile >& headers,
+					     const std::string&		     ns,
+					     const std::string&		     cache_path,
+					     llvm::raw_ostream&		     log )
+	{
+		using namespace clang::tooling;
+		using namespace clang::ast_matchers;
+
+		std::string error;
+		auto	    db = JSONCompilationDatabase::loadFromFile( compile_commands, error, JSONCommandLineSyntax::AutoDetect );
+		if ( !db ) throw std::runtime_error( "[prune] " + error );
+
+		jsoncons::json cache( jsoncons::json_object_arg );
+		if ( std::ifstream in( cache_path ); in ) {
+			try {
+				cache = jsoncons::json::parse( in );
+				if ( !cache.is_object( ) ) throw std::runtime_error( "not an object" );
+			} catch ( const std::exception& ) {
+				log << "[prune] ignoring broken cache " << cache_path << "\n";
+				cache = jsoncons::json( jsoncons::json_object_arg );
+			}
+		}
+
+		std::set< std::string > used;
+		size_t			hits = 0, scanned = 0, failed = 0;
+
+		for ( const auto& cmd : targetCommands( *db, header_dir ) ) {
+			const auto key = fileKey( cmd, headers );
+
+			if ( const auto refs = cachedRefs( cache, cmd.Filename, key, log ) ) {
+				used.insert( refs->begin( ), refs->end( ) );
+				++hits;
+				continue;
+			}
+
+			std::set< std::string > refs;
+			RefCollector		collector( ns + "::", refs );
+			MatchFinder		finder;
+			// Ссылки из --reflection метаданных ( <ns>::_meta ) покрывают все ключи и использованием не считаются
+			finder.addMatcher( declRefExpr( to( varDecl( hasGlobalStorage( ) ).bind( "var" ) ),
+						       unless( hasAncestor( namespaceDecl( hasName( "_meta" ) ) ) ) ),
+					   &collector );
+
+			ClangTool tool( *db, { cmd.Filename } );
+			for ( const auto& vf : headers ) tool.mapVirtualFile( vf.path, vf.content );
+
+			// Встроенные заголовки clang ( stddef.h, ... ) ищутся относительно исполняемого файла, а это cth++, не clang
+#ifdef CTHPP_CLANG_RESOURCE_DIR
+			tool.appendArgumentsAdjuster( getInsertArgumentAdjuster( "-resource-dir=" CTHPP_CLANG_RESOURCE_DIR, ArgumentInsertPosition::END ) );
+#endif
+
+			clang::IgnoringDiagConsumer ignore;
+			tool.setDiagnosticConsumer( &ignore );
+
+			std::vector< std::string > deps;
+			bool			   has_errors = false;
+			ScanActionFactory	   factory( finder, deps, has_errors );
+
+			if ( tool.run( &factory ) || has_errors ) {
+				// Файл с ошибками не кешируется: ссылки после первой ошибки могли потеряться
+				log << "[prune] " << cmd.Filename << " failed to compile\n";
+				++failed;
+			} else {
+				jsoncons::json entry( jsoncons::json_object_arg );
+				entry[ "hash" ] = key;
+				entry[ "deps" ] = jsoncons::json( jsoncons::json_object_arg );
+				entry[ "refs" ] = jsoncons::json( jsoncons::json_array_arg );
+
+				// Сгенерированные заголовки уже входят в key, на диске лежит их прошлая (возможно урезанная) версия
+				for ( const auto& dep : deps ) {
+					auto path = absolutePath( cmd.Directory, dep );
+					if ( std::any_of( headers.begin( ), headers.end( ), [ & ]( const VirtualFile& vf ) { return vf.path == path; } ) ) continue;
+					entry[ "deps" ][ path ] = contentHash( path );
+				}
+				for ( const auto& ref : refs ) entry[ "refs" ].push_back( ref );
+				cache[ cmd.Filename ] = std::move( entry );
+			}
+
+			used.insert( refs.begin( ), refs.end( ) );
+			++scanned;
+		}
+
+		if ( std::ofstream out( cache_path, std::ios::out | std::ios::binary | std::ios::trunc ); out ) cache.dump( out, true );
+
+		log << "[prune] " << scanned << " scanned, " << hits << " cached, " << failed << " with errors\n";
+
+		if ( failed ) return std::nullopt;
+		return used;
+	}
+
+	// Удаляет из ns переменные, которых нет в used, и опустевшие вложенные namespace; удалённые имена попадают в unused
+	inline void prune( clang::NamespaceDecl* ns, const std::set< std::string >& used, std::vector< std::string >& unused )
+	{
+		std::vector< clang::Decl* > remove;
+
+		for ( auto* decl : ns->decls( ) ) {
+			if ( auto* var = llvm::dyn_cast< clang::VarDecl >( decl ) ) {
+				if ( auto name = var->getQualifiedNameAsString( ); !used.contains( name ) ) {
+					unused.push_back( std::move( name ) );
+					remove.push_back( var );
+				}
+			} else if ( auto* child = llvm::dyn_cast< clang::NamespaceDecl >( decl ) ) {
+				prune( child, used, unused );
+				if ( child->decls_empty( ) ) remove.push_back( child );
+			}
+		}
+
+		for ( auto* decl : remove ) ns->removeDecl( decl );
+	}
+}    // namespace usage
+
+#endif	  //USAGE_SCAN_HPP
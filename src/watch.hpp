@@ -0,0 +1,133 @@
+// GPL3 lisence
+//
+// Created by @olokreaz on 19.10.2026.
+//
+
+#ifndef WATCH_HPP
+#define WATCH_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#	include <cerrno>
+#	include <cstring>
+
+#	include <poll.h>
+#	include <sys/inotify.h>
+#	include <unistd.h>
+#endif
+
+// --watch: перегенерация при изменении входных файлов
+namespace watch {
+
+#ifdef __linux__
+	// Наблюдаются каталоги, а не сами файлы: редакторы и git сохраняют через rename, и watch на inode файла теряется
+	class Watcher
+	{
+		int			     fd_;
+		std::map< int, std::string > dirs_;    // wd -> directory
+		std::set< std::string >	     files_;
+
+	public:
+		Watcher( ) : fd_( inotify_init1( IN_NONBLOCK | IN_CLOEXEC ) )
+		{
+			if ( fd_ < 0 ) throw std::runtime_error( std::string( "[watch] inotify_init1: " ) + std::strerror( errno ) );
+		}
+
+		~Watcher( )
+		{
+			close( fd_ );
+		}
+
+		Watcher( const Watcher& )	     = delete;
+		Watcher& operator=( const Watcher& ) = delete;
+
+		void set( const std::vector< std::string >& files )
+		{
+			std::set< std::string > normalized;
+			for ( const auto& file : files )
+				normalized.insert( std::filesystem::absolute( file ).lexically_normal( ).string( ) );
+
+			if ( normalized == files_ ) return;
+
+			for ( const auto& [ wd, dir ] : dirs_ ) inotify_rm_watch( fd_, wd );
+			dirs_.clear( );
+			files_ = std::move( normalized );
+
+			std::set< std::string > dirs;
+			for ( const auto& file : files_ ) dirs.insert( std::filesystem::path( file ).parent_path( ).string( ) );
+
+			for ( const auto& dir : dirs )
+				if ( const int wd = inotify_add_watch( fd_, dir.c_str( ), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE ); wd >= 0 )
+					dirs_[ wd ] = dir;
+		}
+
+		// true, если за timeout_ms (-1 - без ограничения) изменился один из наблюдаемых файлов;
+		// события по соседним файлам в тех же каталогах ожидание не прерывают
+		bool wait( const int timeout_ms )
+		{
+			const auto deadline = std::chrono::steady_clock::now( ) + std::chrono::milliseconds( timeout_ms );
+
+			for ( ;; ) {
+				int left = -1;
+				if ( timeout_ms >= 0 )
+					left = static_cast< int >( std::max< long long >(
+							0,
+							std::chrono::duration_cast< std::chrono::milliseconds >( deadline - std::chrono::steady_clock::now( ) )
+									.count( ) ) );
+
+				pollfd pfd{ fd_, POLLIN, 0 };
+				if ( poll( &pfd, 1, left ) <= 0 ) return false;
+				if ( drain( ) ) return true;
+			}
+		}
+
+	private:
+		bool drain( )
+		{
+			alignas( inotify_event ) char buf[ 4096 ];
+			bool			      hit = false;
+
+			for ( ssize_t len; ( len = read( fd_, buf, sizeof( buf ) ) ) > 0; )
+				for ( const char* p = buf; p < buf + len; ) {
+					const auto* ev = reinterpret_cast< const inotify_event* >( p );
+					if ( ev->len )
+						if ( auto dir = dirs_.find( ev->wd ); dir != dirs_.end( ) )
+							hit |= files_.contains( ( std::filesystem::path( dir->second ) / ev->name ).string( ) );
+					p += sizeof( inotify_event ) + ev->len;
+				}
+
+			return hit;
+		}
+	};
+
+	// regenerate вызывается сразу и затем после каждой серии изменений, как только файлы затихли на debounce;
+	// возвращает список файлов, за которыми следить дальше
+	[[noreturn]] inline void run( const std::function< std::vector< std::string >( ) >& regenerate, const std::chrono::milliseconds debounce )
+	{
+		Watcher watcher;
+		watcher.set( regenerate( ) );
+
+		for ( ;; ) {
+			if ( !watcher.wait( -1 ) ) continue;
+			while ( watcher.wait( static_cast< int >( debounce.count( ) ) ) ) { }
+			watcher.set( regenerate( ) );
+		}
+	}
+#else
+	[[noreturn]] inline void run( const std::function< std::vector< std::string >( ) >&, const std::chrono::milliseconds )
+	{
+		throw std::runtime_error( "[watch] --watch requires inotify (Linux)" );
+	}
+#endif
+}    // namespace watch
+
+#endif	  //WATCH_HPP